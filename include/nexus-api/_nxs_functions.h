@@ -91,6 +91,20 @@ NEXUS_API_FUNC(nxs_int, CreateBuffer,
     void* host_ptr,
     nxs_uint buffer_settings
 )
+/************************************************************************
+ * @def CreateSubBuffer
+ * @brief Create a view of an existing buffer starting `offset` bytes in,
+ *        with its own shape and element strides. The view shares the
+ *        parent's memory and keeps it alive until both are released.
+  * @return Negative value is an error status.
+  *         Non-negative is the bufferId.
+***********************************************************************/
+NEXUS_API_FUNC(nxs_int, CreateSubBuffer,
+    nxs_int buffer_id,
+    nxs_ulong offset,
+    nxs_buffer_layout shape,
+    nxs_uint buffer_settings
+)
 /************************************************************************
  * @def GetBufferProperty
  * @brief Return Buffer properties 
@@ -113,6 +127,20 @@ NEXUS_API_FUNC(nxs_status, CopyBuffer,
     nxs_uint buffer_settings
 )
 
+/************************************************************************
+ * @def CopyBufferRegion
+ * @brief Copy a (strided) region between two buffers, or between a
+ *        buffer and host memory: a negative src/dst buffer id selects
+ *        `host_ptr` for that side.
+ * @return Error status or Succes.
+***********************************************************************/
+NEXUS_API_FUNC(nxs_status, CopyBufferRegion,
+    nxs_int src_buffer_id,
+    nxs_int dst_buffer_id,
+    void* host_ptr,
+    const nxs_buffer_region* region,
+    nxs_uint settings
+)
 /************************************************************************
  * @def FillBuffer
  * @brief Fill buffer on the device with a value
@@ -323,6 +351,26 @@ NEXUS_API_FUNC(nxs_int, CreateCommand,
     nxs_int kernel_id,
     nxs_uint command_settings
 )
+/************************************************************************
+ * @def CreateDispatch
+ * @brief Create a kernel command with all of its arguments and launch
+ *        dims in one call; equivalent to CreateCommand, one
+ *        SetCommandArgument / SetCommandScalar per argument and
+ *        FinalizeCommand, except that nothing is added to the schedule
+ *        when any step fails.
+ * @return Negative value is an error status.
+ *         Non-negative is the commandId.
+ ***********************************************************************/
+NEXUS_API_FUNC(nxs_int, CreateDispatch,
+    nxs_int schedule_id,
+    nxs_int kernel_id,
+    const nxs_command_arg *args,
+    nxs_uint arg_count,
+    nxs_dim3 grid_size,
+    nxs_dim3 block_size,
+    nxs_uint shared_memory_size,
+    nxs_uint command_settings
+)
 /************************************************************************
  * @def CreateSignalCommand
  * @brief Create command to signal an event on the device
@@ -359,7 +407,9 @@ NEXUS_API_FUNC(nxs_status, GetCommandProperty,
 )
 /************************************************************************
  * @def SetCommandArgument
- * @brief Set command argument
+ * @brief Set command argument. On a finalized command this rebinds the
+ *        argument in place: the launch dims are kept and the next run of
+ *        the schedule, captured or not, uses the new buffer.
  * @return Negative value is an error status.
  *         Non-negative is the bufferId.
  ***********************************************************************/
@@ -371,8 +421,9 @@ NEXUS_API_FUNC(nxs_status, GetCommandProperty,
     nxs_uint argument_settings
 )
 /************************************************************************
- * @def SetCommandArgument
- * @brief Set command argument
+ * @def SetCommandScalar
+ * @brief Set command scalar; rebinds it in place on a finalized command,
+ *        like SetCommandArgument.
  * @return Negative value is an error status.
  *         Non-negative is the bufferId.
  ***********************************************************************/
@@ -395,6 +446,16 @@ NEXUS_API_FUNC(nxs_status, FinalizeCommand,
     nxs_dim3 block_size,
     nxs_uint shared_memory_size
 )
+/************************************************************************
+ * @def ReleaseCommand
+ * @brief Remove a kernel command from its schedule and release it, e.g.
+ *        one whose arguments could not be set.
+ * @return Error status or Succes.
+ ***********************************************************************/
+NEXUS_API_FUNC(nxs_status, ReleaseCommand,
+    nxs_int schedule_id,
+    nxs_int command_id
+)
 
 
 #ifdef NEXUS_API_GENERATE_FUNC_ENUM
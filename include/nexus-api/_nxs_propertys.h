@@ -110,6 +110,10 @@ NEXUS_API_PROP(SubUnits,              _prop_str_vec,    "Sub-Unit Vector")
 NEXUS_API_PROP(SubUnitType,           _prop_str,        "Sub-Unit Type")
 
 NEXUS_API_PROP(Keys,                  _prop_int_vec,    "Node Keys")
+/* Every key of the object in one call, packed as records of nxs_long
+   words: the key, the value size in bytes, then the value padded to a
+   whole word (strings with their terminator) */
+NEXUS_API_PROP(Values,                _prop_obj_vec,    "Node Values")
 
 /* Device Properties */
 NEXUS_API_PROP(Vendor,                _prop_str,        "Vendor Name")
@@ -138,6 +142,8 @@ NEXUS_API_PROP(MemoryBusWidth,        _prop_int,        "Memory bus width (bits)
 NEXUS_API_PROP(MaxThreadsPerBlock,    _prop_int,        "Max threads per block")
 NEXUS_API_PROP(TimeStamp,             _prop_int,        "Time stamp (cycles)")
 NEXUS_API_PROP(ElapsedTime,           _prop_flt,        "Elapsed time (ms)")
+NEXUS_API_PROP(TeamBusyTime,          _prop_int_vec,    "Busy time per team of the last run (ns)")
+NEXUS_API_PROP(StepCount,             _prop_int,        "Dependency levels a schedule runs in")
 
 /* Threadgroup Properties */
 NEXUS_API_PROP(MaxThreadsPerThreadgroup, _prop_int,     "Max threads per threadgroup")
@@ -148,6 +154,18 @@ NEXUS_API_PROP(Location,              _prop_str,        "Location")
 NEXUS_API_PROP(MaxTransferRate,       _prop_int,        "Max transfer rate (bytes/sec)")
 NEXUS_API_PROP(UnifiedMemory,         _prop_int,        "Unified Memory present")
 NEXUS_API_PROP(MaxBufferSize,         _prop_int,        "Max buffer size (bytes)")
+NEXUS_API_PROP(Alignment,             _prop_int,        "Allocation alignment (bytes)")
+NEXUS_API_PROP(PageSize,              _prop_int,        "Backing page size (bytes)")
+NEXUS_API_PROP(Placement,             _prop_str,        "NUMA placement policy")
+NEXUS_API_PROP(Offset,                _prop_int,        "Byte offset of a sub-buffer in its parent")
+
+NEXUS_API_PROP(ScratchMemoryUsed,     _prop_int,        "Scratch memory in use (bytes)")
+NEXUS_API_PROP(ScratchMemoryPeak,     _prop_int,        "Peak scratch memory in use (bytes)")
+NEXUS_API_PROP(ScratchMemorySize,     _prop_int,        "Scratch memory reserved (bytes)")
+NEXUS_API_PROP(BufferCacheSize,       _prop_int,        "Idle buffer memory cached (bytes)")
+NEXUS_API_PROP(BufferCacheLimit,      _prop_int,        "Buffer cache retention limit (bytes)")
+NEXUS_API_PROP(BufferCacheHitRate,    _prop_flt,        "Buffer allocations served from the cache")
+NEXUS_API_PROP(BufferCacheFragmentation, _prop_flt,     "Live buffer bytes lost to size classes")
 
 NEXUS_API_PROP(DataTypes,             _prop_str_vec,    "Data Types")
 NEXUS_API_PROP(ClockModes,            _prop_str_vec,    "Clock Modes")
@@ -131,6 +131,45 @@ enum _nxs_execution_settings {
 };
 typedef enum _nxs_execution_settings nxs_execution_settings;
 
+/* ENUM nxs_command_settings */
+/*
+ * Command settings share the low byte with nxs_execution_settings
+ * (e.g. NXS_ExecutionSettings_Timing). Schedule settings are inherited by
+ * commands that do not set their own scheduling mode.
+ *
+ * NXS_CommandSettings_ScheduleStatic:
+ *   - Split the grid into one contiguous range of blocks per team (default)
+ * NXS_CommandSettings_ScheduleDynamic:
+ *   - Teams claim fixed-size chunks of blocks from a shared counter
+ * NXS_CommandSettings_ScheduleGuided:
+ *   - Like dynamic, but chunks shrink with the remaining work down to the
+ *     chunk size
+ * NXS_CommandSettings_BarrierFree:
+ *   - Kernel never waits on the device barrier; the CPU runtime runs warps
+ *     as a plain loop instead of one fiber per warp
+ * NXS_CommandSettings_PackedArgs:
+ *   - Kernel takes a pointer to its argument array and a pointer to the
+ *     launch words (launch size, launch id, shared memory, barrier) instead
+ *     of one parameter per argument; allows up to NXS_KERNEL_MAX_ARGS
+ * NXS_CommandSettings_ChunkSizeShift:
+ *   - Chunk size (in blocks) is stored in the upper 16 bits of the settings,
+ *     see NXS_COMMAND_CHUNK_SIZE. Zero selects a runtime default.
+ */
+enum _nxs_command_settings {
+    NXS_CommandSettings_ScheduleStatic = 1 << 8,
+    NXS_CommandSettings_ScheduleDynamic = 1 << 9,
+    NXS_CommandSettings_ScheduleGuided = 1 << 10,
+    NXS_CommandSettings_ScheduleMask = 7 << 8,
+    NXS_CommandSettings_BarrierFree = 1 << 11,
+    NXS_CommandSettings_PackedArgs = 1 << 12,
+    NXS_CommandSettings_ChunkSizeShift = 16,
+};
+typedef enum _nxs_command_settings nxs_command_settings;
+
+#define NXS_COMMAND_CHUNK_SIZE(n)  (((nxs_uint)(n) & 0xffff) << NXS_CommandSettings_ChunkSizeShift)
+
+inline nxs_uint nxs_command_chunk_size(nxs_uint settings) { return settings >> NXS_CommandSettings_ChunkSizeShift; }
+
 /* ENUM nxs_event_status */
 /*
  * NXS_EventStatus_Submitted:
@@ -193,6 +232,24 @@ enum _nxs_command_arg_type {
 };
 typedef enum _nxs_command_arg_type nxs_command_arg_type;
 
+/* ENUM nxs_command_arg_access */
+/*
+ * NXS_CommandArgAccess_Read:
+ *   - Kernel reads the buffer argument
+ * NXS_CommandArgAccess_Write:
+ *   - Kernel writes the buffer argument
+ *
+ * A buffer argument without either bit is treated as read and written.
+ * Runtimes use the access to decide which commands of a schedule may run
+ * concurrently.
+ */
+enum _nxs_command_arg_access {
+    NXS_CommandArgAccess_Read = 1 << 8,
+    NXS_CommandArgAccess_Write = 1 << 9,
+    NXS_CommandArgAccess_Mask = 3 << 8,
+};
+typedef enum _nxs_command_arg_access nxs_command_arg_access;
+
 /* ENUM nxs_data_type */
 /*
  * NXS_DataType_Undefined:
@@ -258,11 +315,33 @@ typedef enum _nxs_stream_settings nxs_stream_settings;
  *   - Buffer is on device
  * NXS_BufferSettings_Maintain:
  *   - Buffer is maintained by the runtime
+ * NXS_BufferSettings_ZeroCopy:
+ *   - Buffer aliases the host pointer when the device can address it;
+ *     the caller keeps ownership and must keep the memory alive and
+ *     unchanged by the host while commands use it, until the buffer is
+ *     released. Ignored without a host pointer. Kept clear of the data
+ *     type bits that share the createBuffer settings word.
+ * NXS_BufferSettings_AlignPage:
+ *   - Align host memory to a page (the default is 64 bytes)
+ * NXS_BufferSettings_HugePages:
+ *   - Back host memory with 2 MB pages where the system allows it
+ * NXS_BufferSettings_FirstTouch:
+ *   - Initialize host memory in parallel from the device's worker
+ *     threads, so pages are spread over their NUMA nodes instead of all
+ *     landing on the calling thread's (no per-kernel placement)
+ * NXS_BufferSettings_Interleave:
+ *   - Interleave host memory pages across all NUMA nodes
  */
 enum _nxs_buffer_settings {
     NXS_BufferSettings_OnHost = 1 << 0,
     NXS_BufferSettings_OnDevice = 1 << 1,
     NXS_BufferSettings_Maintain = 1 << 2,
+    NXS_BufferSettings_ZeroCopy = 1 << 8,
+    NXS_BufferSettings_AlignPage = 1 << 9,
+    NXS_BufferSettings_HugePages = 1 << 10,
+    NXS_BufferSettings_FirstTouch = 1 << 11,
+    NXS_BufferSettings_Interleave = 1 << 12,
+    NXS_BufferSettings_Mask = 7 | (31 << 8),
 };
 typedef enum _nxs_buffer_settings nxs_buffer_settings;
 
@@ -5,7 +5,7 @@
 #include <nexus/log.h>
 
 #define NXSAPI_LOG(SEVERITY, ...) \
-  ::nexus::LogManager::getInstance().log(SEVERITY, "NXSAPI:" NXSAPI_LOG_MODULE, __VA_ARGS__)
+  NEXUS_LOG_TO("NXSAPI:" NXSAPI_LOG_MODULE, SEVERITY, __VA_ARGS__)
 
 #else
 #define NXSAPI_LOG(SEVERITY, ...)
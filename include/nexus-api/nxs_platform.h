@@ -269,6 +269,30 @@ struct nxs_buffer_layout {
     nxs_ulong stride[NXS_MAX_DIMS];
 };
 
+/* Region of a buffer copy: extent[0] bytes per row, extent[1..rank) rows
+ * per dimension; offsets and the strides of dims 1.. are in bytes
+ * (stride[0] is unused). rank 1 is a plain offset/size range. */
+struct nxs_buffer_region {
+    nxs_uint rank;
+    nxs_ulong extent[NXS_MAX_DIMS];
+    nxs_ulong src_offset;
+    nxs_ulong src_stride[NXS_MAX_DIMS];
+    nxs_ulong dst_offset;
+    nxs_ulong dst_stride[NXS_MAX_DIMS];
+};
+
+/* One kernel argument of nxsCreateDispatch: a buffer when buffer_id is a
+ * valid id, otherwise the scalar at `value` (which the device may read until
+ * the command is released). Without either it is an invalid buffer.
+ * settings are the argument settings of nxsSetCommandArgument /
+ * nxsSetCommandScalar. */
+struct nxs_command_arg {
+    nxs_int buffer_id;
+    void *value;
+    const char *name;
+    nxs_uint settings;
+};
+
 /* Macro names and corresponding values defined by OpenCL */
 #define NXS_CHAR_BIT         8
 #define NXS_SCHAR_MAX        127
@@ -83,8 +83,28 @@ class Buffer : public Object<detail::BufferImpl> {
 
   /// Copy buffer contents to/from host memory depending on direction.
   nxs_status copy(void *_hostBuf, nxs_uint direction = NXS_BufferDeviceToHost);
+  /// Copy `size` bytes starting `offset` bytes into the buffer to/from the
+  /// start of `_hostBuf`.
+  nxs_status copy(void *_hostBuf, nxs_ulong offset, nxs_ulong size,
+                  nxs_uint direction = NXS_BufferDeviceToHost);
+  /// Copy a (strided) region to/from host memory; the buffer side uses the
+  /// src (device to host) or dst (host to device) offset and strides.
+  nxs_status copyRegion(void *_hostBuf, const nxs_buffer_region &region,
+                        nxs_uint direction = NXS_BufferDeviceToHost);
+  /// Copy a (strided) region of this buffer into `dst`.
+  nxs_status copyRegion(Buffer dst, const nxs_buffer_region &region);
   /// Fill the buffer with a scalar pattern described by `value` bytes.
   nxs_status fill(void *value, nxs_uint size_bytes);
+
+  /// Zero-copy view starting `offset` bytes into this buffer; `layout`
+  /// gives its shape and element strides (dtype defaults to this buffer's).
+  /// The view shares this buffer's memory and keeps it alive.
+  Buffer createView(nxs_ulong offset, const Layout &layout,
+                    nxs_uint settings = 0);
+  /// Buffer this one is a view of (empty if it owns its memory).
+  Buffer getParentBuffer() const;
+  /// Byte offset of a view in its parent buffer.
+  nxs_ulong getOffset() const;
 };
 
 typedef Objects<Buffer> Buffers;
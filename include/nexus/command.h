@@ -9,6 +9,8 @@
 
 #include <functional>
 #include <list>
+#include <variant>
+#include <vector>
 
 namespace nexus {
 
@@ -16,11 +18,32 @@ namespace detail {
 class CommandImpl;
 }  // namespace detail
 
+// Argument of a command recorded in one call, see
+// Schedule::createCommand(Kernel, const CommandArgs &, ...)
+struct CommandArg {
+  typedef std::variant<Buffer, nxs_int, nxs_uint, nxs_long, nxs_ulong,
+                       nxs_float, nxs_double, nxs_short, nxs_ushort, nxs_char,
+                       nxs_uchar, bool>
+      Value;
+
+  template <typename T>
+  CommandArg(T value, const char *name = "", nxs_uint settings = 0)
+      : value(value), name(name), settings(settings) {}
+
+  Value value;
+  const char *name;
+  nxs_uint settings;
+};
+
+typedef std::vector<CommandArg> CommandArgs;
+
 // System class
 class Command : public Object<detail::CommandImpl> {
  public:
   Command(detail::Impl base, Kernel kern);
   Command(detail::Impl base, Event event);
+  Command(detail::Impl base, Kernel kern, const CommandArgs &args,
+          nxs_dim3 gridSize, nxs_dim3 groupSize, nxs_uint sharedMemorySize);
   using Object::Object;
 
   std::optional<Property> getProperty(nxs_int prop) const override;
@@ -28,6 +51,8 @@ class Command : public Object<detail::CommandImpl> {
   Kernel getKernel() const;
   Event getEvent() const;
 
+  // On a finalized command this rebinds the argument in place: the owning
+  // schedule, captured or not, runs with the new value from its next run.
   template <typename T>
   nxs_status setArgument(nxs_uint index, T value, const char *name = "", nxs_uint settings = 0);
 
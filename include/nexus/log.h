@@ -3,28 +3,166 @@
 
 #define NEXUS_LOG_DEPTH 30
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+
+// Most verbose severity compiled in (see nxs_log_severity); calls above it
+// expand to nothing. -1 compiles out all logging (NEXUS_ENABLE_LOGGING=OFF).
+#ifndef NEXUS_LOG_MAX_SEVERITY
+#define NEXUS_LOG_MAX_SEVERITY 2
+#endif
 
 namespace nexus {
 
+// Ordered by verbosity: a level logs every severity up to and including it
 enum nxs_log_severity {
   NXS_LOG_ERROR = 0,
-  NXS_LOG_NOTE = 1,
-  NXS_LOG_WARN = 2,
+  NXS_LOG_WARN = 1,
+  NXS_LOG_NOTE = 2,
+};
+
+constexpr int NXS_LOG_OFF = -1;
+
+/************************************************************************
+ * @class LogModule
+ * @brief Runtime level of one log module; call sites keep a pointer to it
+ * so the check before formatting is a single relaxed load.
+ ***********************************************************************/
+class LogModule {
+  std::atomic<int> level{NXS_LOG_OFF};
+
+ public:
+  bool enabled(nxs_log_severity severity) const {
+    return static_cast<int>(severity) <= level.load(std::memory_order_relaxed);
+  }
+  void setLevel(int new_level) {
+    level.store(new_level, std::memory_order_relaxed);
+  }
+};
+
+/************************************************************************
+ * @class LogRing
+ * @brief Bounded multi-producer, single-consumer queue of log lines.
+ *
+ * Producers claim a slot with one CAS on the tail and publish it through
+ * the slot's sequence number; nothing blocks. A full ring drops the line
+ * and counts it.
+ ***********************************************************************/
+class LogRing {
+  static constexpr size_t kSlots = 4096;
+  struct Slot {
+    std::atomic<size_t> sequence;
+    std::string line;
+  };
+  std::unique_ptr<Slot[]> slots{new Slot[kSlots]};
+  alignas(64) std::atomic<size_t> tail{0};
+  alignas(64) std::atomic<size_t> head{0};  // written by the consumer only
+  std::atomic<size_t> dropped{0};
+
+ public:
+  LogRing() {
+    for (size_t i = 0; i < kSlots; ++i)
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  bool push(std::string &&line) {
+    size_t pos = tail.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot &slot = slots[pos % kSlots];
+      size_t seq = slot.sequence.load(std::memory_order_acquire);
+      if (seq == pos) {
+        if (tail.compare_exchange_weak(pos, pos + 1,
+                                       std::memory_order_relaxed)) {
+          slot.line = std::move(line);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (seq < pos) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// @brief Hand every published line to fn; returns how many there were.
+  template <typename F>
+  size_t drain(F &&fn) {
+    size_t pos = head.load(std::memory_order_relaxed);
+    size_t count = 0;
+    for (;; ++pos, ++count) {
+      Slot &slot = slots[pos % kSlots];
+      if (slot.sequence.load(std::memory_order_acquire) != pos + 1) break;
+      fn(slot.line);
+      slot.line.clear();
+      slot.sequence.store(pos + kSlots, std::memory_order_release);
+    }
+    head.store(pos, std::memory_order_release);
+    return count;
+  }
+
+  bool empty() const {
+    return tail.load(std::memory_order_acquire) ==
+           head.load(std::memory_order_acquire);
+  }
+  size_t takeDropped() { return dropped.exchange(0, std::memory_order_relaxed); }
 };
-  
-// Singleton LogManager that owns the log file
+
+// Singleton LogManager that owns the log file.
+//
+// Lines are formatted on the calling thread and queued on a LogRing that a
+// writer thread drains to the file, so logging never takes a lock or
+// flushes on the hot path. Levels come from NEXUS_LOG_LEVEL, a comma
+// separated list of a default level and module=level pairs, e.g.
+// "WARN,buffer=NOTE,NXSAPI:cpu_runtime=OFF". Levels apply while the log is
+// open (NEXUS_LOG_ENABLE=1); a closed log disables every module.
 class LogManager {
 public:
   static LogManager& getInstance() {
-    static LogManager instance;
-    return instance;
+    // Never destroyed: call sites hold LogModule pointers until exit, and
+    // the Shutdown hook below closes the file when this image unloads
+    static LogManager *instance = new LogManager;
+    static struct Shutdown {
+      ~Shutdown() { instance->setOpen(false); }
+    } shutdown;
+    return *instance;
+  }
+
+  static constexpr bool compiled(nxs_log_severity severity) {
+    return static_cast<int>(severity) <= NEXUS_LOG_MAX_SEVERITY;
+  }
+
+  /// @brief Level holder of `module`, created on first use.
+  LogModule *getModule(const char *module) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = modules_[module];
+    if (!entry) {
+      entry.reset(new LogModule);
+      entry->setLevel(getEffectiveLevel(module));
+    }
+    return entry.get();
+  }
+
+  void setLevel(int level) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    defaultLevel_ = level;
+    applyLevels();
+  }
+  void setLevel(const std::string &module, int level) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    moduleLevels_[module] = level;
+    applyLevels();
   }
 
   void setOpen(bool open) {
@@ -34,36 +172,44 @@ public:
       setLogFile(filename);
     } else {
       std::lock_guard<std::mutex> lock(mutex_);
-      logFile_.close();
+      closeFile();
     }
   }
   bool isOpen() const {
-    return logFile_.is_open();
+    return open_.load(std::memory_order_acquire);
   }
 
   template<typename... Args>
   void log(nxs_log_severity severity, const char *module, Args&&... args) {
-    if (logFile_.is_open()) {
-      std::lock_guard<std::mutex> lock(mutex_);
-      const char *severity_str[] = { "ERROR", "NOTE", "WARN" };
-      logFile_ << "[" << module << "]" << severity_str[severity]
-               << std::left << std::setw(NEXUS_LOG_DEPTH) << ": ";
-      ((logFile_ << args), ...);
-      logFile_ << std::endl;
-    }
+    if (!isOpen()) return;
+    const char *severity_str[] = { "ERROR", "WARN", "NOTE" };
+    std::ostringstream line;
+    line << "[" << module << "]" << severity_str[severity]
+         << std::left << std::setw(NEXUS_LOG_DEPTH) << ": ";
+    ((line << args), ...);
+    line << '\n';
+    ring_.push(line.str());
   }
-  
+
+  /// @brief Wait until the writer has taken every queued line.
+  void flush() {
+    while (isOpen() && !ring_.empty())
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
   void setLogFile(const std::string& filename) {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (logFile_.is_open()) {
-      logFile_.close();
-    }
+    closeFile();
     logFile_.open(filename, std::ios::out | std::ios::app);
     if (!logFile_.is_open()) {
       std::cerr << "Failed to open log file: " << filename << std::endl;
+      return;
     }
+    open_.store(true, std::memory_order_release);
+    writer_ = std::thread([this] { writeLoop(); });
+    applyLevels();
   }
-  
+
   // Disable copy and move
   LogManager(const LogManager&) = delete;
   LogManager& operator=(const LogManager&) = delete;
@@ -72,20 +218,92 @@ public:
 
 private:
   LogManager() {
+    if (const char *levels = std::getenv("NEXUS_LOG_LEVEL"))
+      parseLevels(levels);
     const char* logPath = std::getenv("NEXUS_LOG_ENABLE");
     bool enable = logPath ? std::stoi(logPath) : false;
     setOpen(enable);
   }
-  
-  ~LogManager() { setOpen(false); }
-  
+
+  static int parseLevel(const std::string &name) {
+    if (name == "ERROR") return NXS_LOG_ERROR;
+    if (name == "WARN") return NXS_LOG_WARN;
+    if (name == "NOTE") return NXS_LOG_NOTE;
+    if (name == "OFF") return NXS_LOG_OFF;
+    return std::atoi(name.c_str());
+  }
+
+  void parseLevels(const std::string &spec) {
+    std::istringstream entries(spec);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+      auto eq = entry.find('=');
+      if (eq == std::string::npos)
+        defaultLevel_ = parseLevel(entry);
+      else
+        moduleLevels_[entry.substr(0, eq)] = parseLevel(entry.substr(eq + 1));
+    }
+  }
+
+  // Callers hold mutex_
+  int getEffectiveLevel(const std::string &module) const {
+    if (!isOpen()) return NXS_LOG_OFF;
+    auto it = moduleLevels_.find(module);
+    return it != moduleLevels_.end() ? it->second : defaultLevel_;
+  }
+  void applyLevels() {
+    for (auto &entry : modules_)
+      entry.second->setLevel(getEffectiveLevel(entry.first));
+  }
+  void closeFile() {
+    if (!isOpen()) return;
+    open_.store(false, std::memory_order_release);
+    applyLevels();
+    writer_.join();
+    logFile_.close();
+  }
+
+  void writeLoop() {
+    for (;;) {
+      bool stopping = !isOpen();
+      size_t written =
+          ring_.drain([&](const std::string &line) { logFile_ << line; });
+      if (size_t dropped = ring_.takeDropped())
+        logFile_ << "[log]WARN" << std::left << std::setw(NEXUS_LOG_DEPTH)
+                 << ": " << dropped << " lines dropped\n";
+      if (written) logFile_.flush();
+      if (stopping) return;
+      if (!written)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
   std::ofstream logFile_;
   std::mutex mutex_;
+  std::atomic<bool> open_{false};
+  std::thread writer_;
+  LogRing ring_;
+  int defaultLevel_ = NXS_LOG_NOTE;
+  std::map<std::string, int> moduleLevels_;
+  std::map<std::string, std::unique_ptr<LogModule>> modules_;
 };
 
 } // namespace nexus
 
+// The severity and module level are checked before any argument is
+// evaluated; each call site resolves its module once.
+#define NEXUS_LOG_TO(MODULE, SEVERITY, ...)                                 \
+  do {                                                                      \
+    if (::nexus::LogManager::compiled(SEVERITY)) {                          \
+      static ::nexus::LogModule *nxs_log_module_ =                          \
+          ::nexus::LogManager::getInstance().getModule(MODULE);             \
+      if (nxs_log_module_->enabled(SEVERITY))                               \
+        ::nexus::LogManager::getInstance().log(SEVERITY, MODULE,            \
+                                               __VA_ARGS__);                \
+    }                                                                       \
+  } while (0)
+
 #define NEXUS_LOG(SEVERITY, ...) \
-  ::nexus::LogManager::getInstance().log(SEVERITY, NEXUS_LOG_MODULE, __VA_ARGS__)
+  NEXUS_LOG_TO(NEXUS_LOG_MODULE, SEVERITY, __VA_ARGS__)
 
-#endif  // NEXUS_LOG_H
\ No newline at end of file
+#endif  // NEXUS_LOG_H
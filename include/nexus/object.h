@@ -6,18 +6,27 @@
 
 #include <memory>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
 namespace nexus {
 
 namespace detail {
 
+class RuntimeImpl;
+class DeviceImpl;
+
 // All Actual objects need an owner (except System)
 // + and ID within the owner
+//
+// The runtime and device an object belongs to are resolved from its owner
+// at construction, so API calls do not walk the owner chain.
 class Impl {
  public:
   Impl(Impl *_owner = nullptr, nxs_int _id = -1, nxs_uint _settings = 0)
-      : owner(_owner), id(_id), settings(_settings) {}
+      : owner(_owner), id(_id), settings(_settings),
+        runtime(_owner ? _owner->getOwnedRuntime() : nullptr),
+        device(_owner ? _owner->getOwnedDevice() : nullptr) {}
   virtual ~Impl() {}
 
   nxs_int getId() const { return id; }
@@ -36,15 +45,41 @@ class Impl {
 
   template <typename T>
   T *getParentOfType() const {
-    if (auto *par = dynamic_cast<T *>(owner)) return par;
-    if (owner) return owner->getParentOfType<T>();
-    return nullptr;
+    if constexpr (std::is_same_v<T, RuntimeImpl>) {
+      return runtime;
+    } else if constexpr (std::is_same_v<T, DeviceImpl>) {
+      return device;
+    } else {
+      if (auto *par = dynamic_cast<T *>(owner)) return par;
+      if (owner) return owner->getParentOfType<T>();
+      return nullptr;
+    }
   }
 
+ protected:
+  /// @brief Objects created by their own constructor learn their id late.
+  void setId(nxs_int _id) { id = _id; }
+
+  /// @brief Mark this object as the runtime (device) of the objects it
+  /// owns; called by RuntimeImpl (DeviceImpl) before creating children.
+  void setOwnedRuntime(RuntimeImpl *self) { owned_runtime = self; }
+  void setOwnedDevice(DeviceImpl *self) { owned_device = self; }
+
  private:
+  RuntimeImpl *getOwnedRuntime() const {
+    return owned_runtime ? owned_runtime : runtime;
+  }
+  DeviceImpl *getOwnedDevice() const {
+    return owned_device ? owned_device : device;
+  }
+
   Impl *owner;
   nxs_int id;
   nxs_uint settings;
+  RuntimeImpl *runtime;
+  DeviceImpl *device;
+  RuntimeImpl *owned_runtime = nullptr;
+  DeviceImpl *owned_device = nullptr;
 };
 
 }  // namespace detail
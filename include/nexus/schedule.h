@@ -21,6 +21,11 @@ class Schedule : public Object<detail::ScheduleImpl> {
   std::optional<Property> getProperty(nxs_int prop) const override;
 
   Command createCommand(Kernel kern, nxs_uint settings = 0);
+  /// @brief Create a command with all of its arguments and launch dims;
+  /// one call into runtimes that support it.
+  Command createCommand(Kernel kern, const CommandArgs &args,
+                        nxs_dim3 gridSize, nxs_dim3 groupSize,
+                        nxs_uint sharedMemorySize = 0, nxs_uint settings = 0);
   Command createSignalCommand(nxs_int signal_value = 1, nxs_uint settings = 0);
   Command createSignalCommand(Event event, nxs_int signal_value = 1,
                               nxs_uint settings = 0);
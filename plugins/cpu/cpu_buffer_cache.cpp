@@ -0,0 +1,110 @@
+#include "cpu_buffer_cache.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using nxs::rt::HostMemory;
+
+namespace {
+
+size_t initLimit() {
+  if (const char *env = std::getenv("NEXUS_CPU_BUFFER_CACHE_LIMIT"))
+    return std::strtoull(env, nullptr, 0);
+  return size_t(1) << 30;
+}
+
+}  // namespace
+
+CpuBufferCache::CpuBufferCache() : limit(initLimit()) {}
+
+CpuBufferCache::~CpuBufferCache() { trim(0); }
+
+size_t CpuBufferCache::getClassSize(size_t size) {
+  if (size <= 256) return 256;
+  // size in (2^k, 2^(k+1)]: four classes of 2^(k-2)
+  int k = 63 - __builtin_clzll(size - 1);
+  size_t step = size_t(1) << (k - 2);
+  return nxs::rt::roundUp(size, step);
+}
+
+HostMemory CpuBufferCache::allocate(size_t size, nxs_uint settings) {
+  size_t class_size = getClassSize(size);
+  auto key = std::make_pair(class_size, settings & kind_settings);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    live_requested += size;
+    live_allocated += class_size;
+    auto it = bins.find(key);
+    if (it != bins.end() && !it->second.empty()) {
+      HostMemory memory = it->second.back();
+      it->second.pop_back();
+      cached_bytes -= memory.bytes;
+      hits++;
+      return memory;
+    }
+    misses++;
+  }
+  HostMemory memory = nxs::rt::allocateHostMemory(class_size, settings);
+  if (!memory.ptr) {
+    // under pressure: give everything idle back and try once more
+    trim(0);
+    memory = nxs::rt::allocateHostMemory(class_size, settings);
+  }
+  if (!memory.ptr) {
+    std::lock_guard<std::mutex> lock(mutex);
+    live_requested -= size;
+    live_allocated -= class_size;
+  }
+  return memory;
+}
+
+void CpuBufferCache::release(HostMemory memory, size_t size,
+                             nxs_uint settings) {
+  if (!memory.ptr) return;
+  size_t class_size = getClassSize(size);
+  std::lock_guard<std::mutex> lock(mutex);
+  live_requested -= std::min(live_requested, size);
+  live_allocated -= std::min(live_allocated, class_size);
+  // memory not shaped by allocate() (e.g. a resized buffer) is not reused
+  if (memory.bytes < class_size || memory.bytes > limit) {
+    nxs::rt::freeHostMemory(memory);
+    return;
+  }
+  bins[std::make_pair(class_size, settings & kind_settings)].push_back(memory);
+  cached_bytes += memory.bytes;
+  if (cached_bytes > limit) trimLocked(limit);
+}
+
+void CpuBufferCache::trimLocked(size_t target) {
+  for (auto it = bins.rbegin(); it != bins.rend() && cached_bytes > target;
+       ++it) {
+    auto &bin = it->second;
+    while (!bin.empty() && cached_bytes > target) {
+      cached_bytes -= bin.back().bytes;
+      nxs::rt::freeHostMemory(bin.back());
+      bin.pop_back();
+    }
+  }
+}
+
+void CpuBufferCache::trim(size_t target) {
+  std::lock_guard<std::mutex> lock(mutex);
+  trimLocked(target);
+}
+
+size_t CpuBufferCache::getCachedBytes() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return cached_bytes;
+}
+
+double CpuBufferCache::getHitRate() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return hits + misses ? double(hits) / double(hits + misses) : 0.0;
+}
+
+double CpuBufferCache::getFragmentation() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return live_allocated
+             ? double(live_allocated - live_requested) / double(live_allocated)
+             : 0.0;
+}
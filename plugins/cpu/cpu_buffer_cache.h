@@ -0,0 +1,75 @@
+#ifndef RT_CPU_BUFFER_CACHE_H
+#define RT_CPU_BUFFER_CACHE_H
+
+#include <nexus-api.h>
+#include <rt_host_memory.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/************************************************************************
+ * @class CpuBufferCache
+ * @brief Size-class cache of host memory for maintained CPU buffers.
+ *
+ * Requests are rounded up to a size class (four classes per power of two
+ * from 256 bytes, so at most 25% is lost to rounding) and released memory
+ * is kept in a bin per class and allocation kind instead of being freed.
+ * An inference loop that allocates the same shapes every iteration hits
+ * the cache after the first one and makes no system allocations.
+ * Memory must only be released once no queued stream work can touch it
+ * (CpuRuntime::releaseBuffer waits for the streams using it first).
+ *
+ * The cache holds at most `limit` idle bytes (NEXUS_CPU_BUFFER_CACHE_LIMIT,
+ * default 1 GiB, 0 disables caching). Going over the limit trims the
+ * largest classes first, and a failed system allocation trims everything
+ * before retrying.
+ ***********************************************************************/
+class CpuBufferCache {
+  // settings that change how memory is allocated; part of the bin key
+  static constexpr nxs_uint kind_settings =
+      NXS_BufferSettings_AlignPage | NXS_BufferSettings_HugePages |
+      NXS_BufferSettings_FirstTouch | NXS_BufferSettings_Interleave;
+
+  std::mutex mutex;
+  // (class size, kind settings) -> idle allocations
+  std::map<std::pair<size_t, nxs_uint>, std::vector<nxs::rt::HostMemory>>
+      bins;
+  size_t limit;
+  size_t cached_bytes = 0;
+  size_t live_requested = 0;
+  size_t live_allocated = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+
+  void trimLocked(size_t target);
+
+ public:
+  CpuBufferCache();
+  ~CpuBufferCache();
+  CpuBufferCache(const CpuBufferCache &) = delete;
+  CpuBufferCache &operator=(const CpuBufferCache &) = delete;
+
+  /// @brief Size class `size` is rounded up to.
+  static size_t getClassSize(size_t size);
+
+  /// @brief Memory for a buffer of `size` bytes, reused when possible.
+  nxs::rt::HostMemory allocate(size_t size, nxs_uint settings);
+  /// @brief Take back memory from allocate() for a buffer of `size` bytes.
+  void release(nxs::rt::HostMemory memory, size_t size, nxs_uint settings);
+
+  /// @brief Free idle memory until at most `target` bytes stay cached.
+  void trim(size_t target = 0);
+
+  size_t getLimit() const { return limit; }
+  size_t getCachedBytes();
+  /// @brief Fraction of allocations served from the cache.
+  double getHitRate();
+  /// @brief Fraction of the bytes held by live buffers lost to rounding.
+  double getFragmentation();
+};
+
+#endif  // RT_CPU_BUFFER_CACHE_H
@@ -1,40 +1,164 @@
-
 #include <cpu_command.h>
 #include <cpu_runtime.h>
+#include <cpu_scratch.h>
 #include <nexus/log.h>
 #include <rt_buffer.h>
 
 #include <boost/fiber/all.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <optional>
+
 /************************************************************************
  * @def _cpu_barrier
  * @brief Barrier for CPU fibers
  * @return void
  ***********************************************************************/
-extern "C" void NXS_API_CALL _cpu_barrier(void *barrier) {
+extern "C" __attribute__((visibility("default"))) void NXS_API_CALL
+_cpu_barrier(void *barrier) {
   boost::fibers::barrier *barrier_ptr =
       static_cast<boost::fibers::barrier *>(barrier);
   barrier_ptr->wait();
 }
 
-nxs_status CpuCommand::runCommand(nxs_int stream) {
-  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "runCommand ", kernel, " - ", type);
+/// @brief Call a CPU kernel with its argument frame: packed kernels get the
+/// frame and its launch words, the others the first 32 words spread out.
+static inline void invokeKernel(cpuFunction_t kernel, void *const *frame,
+                                bool packed_args, int coords_idx) {
+  if (packed_args) {
+    reinterpret_cast<cpuPackedFunction_t>(kernel)(frame,
+                                                  frame + coords_idx - 1);
+    return;
+  }
+  kernel(frame[0], frame[1], frame[2], frame[3], frame[4], frame[5], frame[6],
+         frame[7], frame[8], frame[9], frame[10], frame[11], frame[12],
+         frame[13], frame[14], frame[15], frame[16], frame[17], frame[18],
+         frame[19], frame[20], frame[21], frame[22], frame[23], frame[24],
+         frame[25], frame[26], frame[27], frame[28], frame[29], frame[30],
+         frame[31]);
+}
+
+nxs_status CpuCommand::setArgument(nxs_int argument_index,
+                                   nxs::rt::Buffer *buffer, const char *name,
+                                   nxs_uint argument_settings) {
+  auto status =
+      Command::setArgument(argument_index, buffer, name, argument_settings);
+  if (!nxs_success(status)) return status;
+
+  nxs_uint access = argument_settings & NXS_CommandArgAccess_Mask;
+  auto *data = static_cast<const char *>(buffer->get());
+  buffer_access[argument_index] = {data, data + buffer->getExtentBytes(),
+                                   access != NXS_CommandArgAccess_Read};
+  patchFrame(argument_index);
+  ++revision;
+  return NXS_Success;
+}
+
+nxs_status CpuCommand::setScalar(nxs_int argument_index, void *value,
+                                 const char *name,
+                                 nxs_uint argument_settings) {
+  auto status =
+      Command::setScalar(argument_index, value, name, argument_settings);
+  if (!nxs_success(status)) return status;
+  if (!(argument_settings & NXS_CommandArgType_Constant)) {
+    buffer_access[argument_index] = {};
+    patchFrame(argument_index);
+  }
+  ++revision;
+  return NXS_Success;
+}
 
-  if (getArgsCount() >= 32) {
+void CpuCommand::patchFrame(nxs_int argument_index) {
+  if (argument_index < coords_idx - 1) {
+    arg_frame[argument_index] = args[argument_index].value;
+    return;
+  }
+  if (coords_idx == 0) return;
+  // The launch words move up; the frame is rebuilt by the next finalize
+  coords_idx = 0;
+  ++layout_revision;
+}
+
+bool CpuCommand::conflictsWith(const CpuCommand &other) const {
+  for (int i = 0; i < getArgsCount(); ++i) {
+    auto &a = buffer_access[i];
+    if (a.begin == a.end) continue;
+    for (int j = 0; j < other.getArgsCount(); ++j) {
+      auto &b = other.buffer_access[j];
+      if (b.begin == b.end || !(a.write || b.write)) continue;
+      if (a.begin < b.end && b.begin < a.end) return true;
+    }
+  }
+  return false;
+}
+
+bool CpuCommand::touches(const char *begin, const char *end) const {
+  for (int i = 0; i < getArgsCount(); ++i) {
+    auto &a = buffer_access[i];
+    if (a.begin != a.end && a.begin < end && begin < a.end) return true;
+  }
+  return false;
+}
+
+nxs_status CpuCommand::finalize(nxs_dim3 grid_size, nxs_dim3 block_size,
+                                nxs_uint shared_memory_size) {
+  auto status = Command::finalize(grid_size, block_size, shared_memory_size);
+  if (!nxs_success(status)) return status;
+  ++revision;
+  ++layout_revision;
+
+  // user args + launch_size, launch_id, shared memory and barrier; packed
+  // kernels only see a pointer to the frame, so they take every argument.
+  // The pointer ABI passes the first 32 words: as before, up to 31
+  // arguments are accepted and the launch words that do not fit are cut.
+  bool packed = settings & NXS_CommandSettings_PackedArgs;
+  if (packed ? getArgsCount() + 4 > CPU_COMMAND_MAX_FRAME
+             : getArgsCount() + 1 > CPU_COMMAND_MAX_ARGS) {
     NXSAPI_LOG(nexus::NXS_LOG_ERROR, "Too many arguments for kernel");
+    coords_idx = 0;
     return NXS_InvalidCommand;
   }
-  std::array<void *, NXS_KERNEL_MAX_ARGS> bufs;  // max 32 args
-  for (size_t i = 0; i < getArgsCount(); i++) {
-    bufs[i] = args[i].value;
-  }
 
-  int32_t launch_size[] = {
+  launch_size = {
       static_cast<int32_t>(grid_size.x),  static_cast<int32_t>(grid_size.y),
       static_cast<int32_t>(grid_size.z),  static_cast<int32_t>(block_size.x),
       static_cast<int32_t>(block_size.y), static_cast<int32_t>(block_size.z)};
-  bufs[getArgsCount()] = &launch_size;
-  int coords_idx = getArgsCount() + 1;
+
+  // Everything but the per-team words is fixed from here on
+  arg_frame.fill(nullptr);
+  for (int i = 0; i < getArgsCount(); i++) arg_frame[i] = args[i].value;
+  arg_frame[getArgsCount()] = launch_size.data();
+  coords_idx = getArgsCount() + 1;
+  return NXS_Success;
+}
+
+nxs_status CpuCommand::runCommand(nxs_int stream) {
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "runCommand ", kernel, " - ", type);
+
+  switch (type) {
+    case NXS_CommandType_Dispatch:
+      return runDispatch();
+    case NXS_CommandType_Signal:
+      if (!event) return NXS_InvalidEvent;
+      event->signal(event_value);
+      return NXS_Success;
+    case NXS_CommandType_Wait:
+      // Streams park on the event instead (see CpuStream); this is the
+      // blocking path for synchronous runs.
+      if (!event) return NXS_InvalidEvent;
+      event->wait(event_value);
+      return NXS_Success;
+  }
+  return NXS_InvalidCommand;
+}
+
+nxs_status CpuCommand::prepareLaunch(CpuLaunch &launch) {
+  if (!kernel) return NXS_InvalidKernel;
+  if (coords_idx == 0) {
+    NXSAPI_LOG(nexus::NXS_LOG_ERROR, "Command is not finalized");
+    return NXS_InvalidCommand;
+  }
 
   int32_t thread_count = rt->getNumCores();
   int32_t global_size = grid_size.x * grid_size.y * grid_size.z;
@@ -42,14 +166,11 @@ nxs_status CpuCommand::runCommand(nxs_int stream) {
   int32_t blocks_per_thread =
       global_size / thread_count + !!(global_size % thread_count);
 
-  unsigned char *shared_memory_ptr = nullptr;
-  int32_t shared_memory_aligned_per_team = 0;
+  // Teams borrow their shared memory from the executing worker's arena
+  size_t shared_memory_aligned_per_team = 0;
   if (shared_memory_size > 0) {
     shared_memory_aligned_per_team = (shared_memory_size + 63) & ~63u;
     shared_memory_aligned_per_team += 64 * block_size.x;
-    unsigned shared_memory_aligned_total = shared_memory_aligned_per_team * thread_count;
-    shared_memory_ptr = (unsigned char*)aligned_alloc(64, shared_memory_aligned_total);
-    assert(shared_memory_ptr);
   }
 
   NXSAPI_LOG(nexus::NXS_LOG_NOTE,
@@ -57,62 +178,174 @@ nxs_status CpuCommand::runCommand(nxs_int stream) {
                              , ", thread_count: ", thread_count
                              , ", blocks_per_thread: ", blocks_per_thread);
 
-  boost::fibers::use_scheduling_algorithm<boost::fibers::algo::shared_work>();
+  nxs_uint schedule_mode = settings & NXS_CommandSettings_ScheduleMask;
+  int32_t chunk_size = nxs_command_chunk_size(settings);
+  if (chunk_size == 0) {
+    // default to ~8 chunks per team for dynamic, single blocks for guided
+    chunk_size = schedule_mode == NXS_CommandSettings_ScheduleDynamic
+                     ? std::max(global_size / (thread_count * 8), 1)
+                     : 1;
+  }
 
-  // Capture futures to wait on
-  std::vector<std::future<void>> futures;
-  futures.reserve(thread_count);
+  team_busy_ns.assign(thread_count, 0);
 
-  for (int32_t team_id = 0; team_id < thread_count; team_id++) {
-    futures.push_back(rt->getThreadPool()->enqueue([&, team_id]() {
-      const int32_t block_start = blocks_per_thread * team_id;
+  launch.kernel = kernel;
+  launch.frame = arg_frame;
+  launch.coords_idx = coords_idx;
+  launch.packed_args = settings & NXS_CommandSettings_PackedArgs;
+  launch.grid_size = grid_size;
+  launch.block_size = block_size;
+  launch.global_size = global_size;
+  launch.teams = thread_count;
+  launch.blocks_per_team = blocks_per_thread;
+  launch.chunk_size = chunk_size;
+  launch.shared_memory_per_team = shared_memory_aligned_per_team;
+  launch.scratch = rt->getScratch();
+  launch.schedule_mode = schedule_mode;
+  // Kernels that never call _cpu_barrier run their warps as a plain loop
+  launch.barrier_free = settings & NXS_CommandSettings_BarrierFree;
+  launch.team_busy_ns = team_busy_ns.data();
+  return NXS_Success;
+}
 
-      std::vector<boost::fibers::fiber> fibers;
-      fibers.reserve(block_size.x);
+nxs_status CpuCommand::runDispatch() {
+  CpuLaunch launch;
+  auto status = prepareLaunch(launch);
+  if (!nxs_success(status)) return status;
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  execute(rt->getThreadPool(), launch);
+
+  if (settings & NXS_ExecutionSettings_Timing) {
+    time_ms = std::chrono::duration<float, std::milli>(
+                  std::chrono::steady_clock::now() - start_time)
+                  .count();
+  }
+
+  return NXS_Success;
+}
+
+void CpuCommand::execute(ThreadPool *pool, const CpuLaunch &launch) {
+  const nxs_dim3 grid_size = launch.grid_size;
+  const nxs_dim3 block_size = launch.block_size;
+  const int32_t global_size = launch.global_size;
+  const int32_t thread_count = launch.teams;
+  const int32_t chunk_size = launch.chunk_size;
+  const int coords_idx = launch.coords_idx;
+  const cpuFunction_t kernel = launch.kernel;
+  const bool barrier_free = launch.barrier_free;
+  const bool packed_args = launch.packed_args;
+  std::atomic<int32_t> next_block{0};
+
+  if (!barrier_free) {
+    // Install the work-sharing fiber scheduler once per launching thread
+    static thread_local bool shared_work = [] {
+      boost::fibers::use_scheduling_algorithm<
+          boost::fibers::algo::shared_work>();
+      return true;
+    }();
+    (void)shared_work;
+  }
+
+  // Fork-join over teams; the calling thread helps until all teams finish
+  pool->parallel_for(thread_count, [&](size_t team_id) {
+    auto team_start = std::chrono::steady_clock::now();
 
-      void *shared_memory_ptr_team = shared_memory_ptr + shared_memory_aligned_per_team * team_id;
+    auto shared_memory = launch.scratch->borrow(launch.shared_memory_per_team,
+                                                pool->workerIndex());
+    void *shared_memory_ptr_team = shared_memory.data();
 
-      boost::fibers::barrier barrier(block_size.x);
-      void *cpu_barrier = &barrier;
+    std::vector<boost::fibers::fiber> fibers;
+    std::optional<boost::fibers::barrier> barrier;
+    if (!barrier_free) {
+      fibers.reserve(block_size.x);
+      barrier.emplace(block_size.x);
+    }
 
-      // for each warp in a block
+    // run blocks [block_start, block_end)
+    auto run_blocks = [&](int32_t block_start, int32_t block_end) {
+      if (barrier_free) {
+        nxs_uint launch_id[6] = {0};
+        auto frame = launch.frame;
+        frame[coords_idx] = launch_id;
+        frame[coords_idx + 1] = shared_memory_ptr_team;
+        for (nxs_uint grid_idx = block_start; grid_idx < block_end;
+             grid_idx++) {
+          launch_id[0] = grid_idx % grid_size.x;
+          launch_id[1] = (grid_idx % (grid_size.x * grid_size.y)) / grid_size.x;
+          launch_id[2] = grid_idx / (grid_size.x * grid_size.y);
+          for (nxs_uint warp_idx = 0; warp_idx < block_size.x; warp_idx++) {
+            launch_id[3] = warp_idx;
+            invokeKernel(kernel, frame.data(), packed_args, coords_idx);
+          }
+        }
+        return;
+      }
+
+      // one fiber per warp so that warps can meet at the barrier
+      fibers.clear();
       for (nxs_uint warp_idx = 0; warp_idx < block_size.x; warp_idx++) {
-        fibers.push_back(boost::fibers::fiber([&, warp_idx, block_start]() {
-          auto block_end =
-              std::min(block_start + blocks_per_thread, global_size);
+        fibers.push_back(boost::fibers::fiber([&, warp_idx]() {
+          nxs_uint launch_id[6] = {0, 0, 0, warp_idx, 0, 0};
+          auto frame = launch.frame;
+          frame[coords_idx] = launch_id;
+          frame[coords_idx + 1] = shared_memory_ptr_team;
+          frame[coords_idx + 2] = &*barrier;
           for (nxs_uint grid_idx = block_start; grid_idx < block_end;
                grid_idx++) {
-            nxs_uint launch_id[] = {
-                grid_idx % grid_size.x,
-                (grid_idx % (grid_size.x * grid_size.y)) / grid_size.x,
-                grid_idx / (grid_size.x * grid_size.y),
-                warp_idx,
-                0,
-                0};
-            auto gptr = [&](int p) {
-              return p == coords_idx     ? launch_id
-                   : p == coords_idx + 1 ? shared_memory_ptr
-                   : p == coords_idx + 2 ? cpu_barrier
-                                         : bufs[p];
-            };
-            std::invoke(kernel, gptr(0), gptr(1), gptr(2), gptr(3), gptr(4),
-                        gptr(5), gptr(6), gptr(7), gptr(8), gptr(9), gptr(10),
-                        gptr(11), gptr(12), gptr(13), gptr(14), gptr(15),
-                        gptr(16), gptr(17), gptr(18), gptr(19), gptr(20),
-                        gptr(21), gptr(22), gptr(23), gptr(24), gptr(25),
-                        gptr(26), gptr(27), gptr(28), gptr(29), gptr(30),
-                        gptr(31));
+            launch_id[0] = grid_idx % grid_size.x;
+            launch_id[1] =
+                (grid_idx % (grid_size.x * grid_size.y)) / grid_size.x;
+            launch_id[2] = grid_idx / (grid_size.x * grid_size.y);
+            invokeKernel(kernel, frame.data(), packed_args, coords_idx);
+            // the next block reuses the team's shared memory
+            if (grid_idx + 1 < block_end) barrier->wait();
           }
         }));
       }
       for (auto &fiber : fibers) {
         fiber.join();
       }
-    }));
-  }
-  for (auto &future : futures) {
-    future.wait();
-  }
+    };
 
-  return NXS_Success;
+    switch (launch.schedule_mode) {
+      case NXS_CommandSettings_ScheduleDynamic:
+        for (;;) {
+          int32_t block_start =
+              next_block.fetch_add(chunk_size, std::memory_order_relaxed);
+          if (block_start >= global_size) break;
+          run_blocks(block_start,
+                     std::min(block_start + chunk_size, global_size));
+        }
+        break;
+      case NXS_CommandSettings_ScheduleGuided:
+        for (;;) {
+          int32_t block_start = next_block.load(std::memory_order_relaxed);
+          int32_t count = 0;
+          do {
+            int32_t remaining = global_size - block_start;
+            if (remaining <= 0) break;
+            count = std::min(
+                std::max(remaining / (2 * thread_count), chunk_size),
+                remaining);
+          } while (!next_block.compare_exchange_weak(
+              block_start, block_start + count, std::memory_order_relaxed));
+          if (block_start >= global_size) break;
+          run_blocks(block_start, block_start + count);
+        }
+        break;
+      default: {
+        const int32_t block_start = launch.blocks_per_team * team_id;
+        run_blocks(block_start,
+                   std::min(block_start + launch.blocks_per_team, global_size));
+        break;
+      }
+    }
+
+    launch.team_busy_ns[team_id] =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - team_start)
+            .count();
+  });
 }
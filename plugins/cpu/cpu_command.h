@@ -4,9 +4,21 @@
 #include <nexus-api/nxs_log.h>
 #define NXSAPI_LOG_MODULE "cpu_runtime"
 
+#include <cpu_event.h>
 #include <rt_command.h>
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
+// cpuFunction_t takes 32 pointer arguments
+#define CPU_COMMAND_MAX_ARGS 32
+// Frame of a packed kernel: its arguments followed by the launch words
+#define CPU_COMMAND_MAX_FRAME (NXS_KERNEL_MAX_ARGS + 4)
+
 class CpuRuntime;
+class CpuScratch;
+class ThreadPool;
 
 typedef void (*cpuFunction_t)(void *, void *, void *, void *, void *, void *,
                               void *, void *, void *, void *, void *, void *,
@@ -15,22 +27,115 @@ typedef void (*cpuFunction_t)(void *, void *, void *, void *, void *, void *,
                               void *, void *, void *, void *, void *, void *,
                               void *, void *);
 
-class CpuCommand : public nxs::rt::Command<cpuFunction_t, nxs_int, nxs_int> {
+// Packed ABI (NXS_CommandSettings_PackedArgs): args points at the argument
+// words and launch at launch_size, launch_id, shared memory and barrier
+typedef void (*cpuPackedFunction_t)(void *const *args, void *const *launch);
+
+/************************************************************************
+ * @struct CpuLaunch
+ * @brief Fully resolved dispatch: kernel, argument frame and partitioning.
+ *
+ * Running one needs no validation, allocation or logging. Captured
+ * schedules keep an array of these and replay them directly.
+ ***********************************************************************/
+struct CpuLaunch {
+  cpuFunction_t kernel = nullptr;
+  std::array<void *, CPU_COMMAND_MAX_FRAME> frame{};
+  int coords_idx = 0;
+  bool packed_args = false;
+  nxs_dim3 grid_size{};
+  nxs_dim3 block_size{};
+  int32_t global_size = 0;
+  int32_t teams = 0;
+  int32_t blocks_per_team = 0;
+  int32_t chunk_size = 1;
+  size_t shared_memory_per_team = 0;
+  CpuScratch *scratch = nullptr;  // arenas the teams borrow from
+  nxs_uint schedule_mode = 0;
+  bool barrier_free = false;
+  nxs_long *team_busy_ns = nullptr;  // one slot per team
+};
+
+class CpuCommand
+    : public nxs::rt::Command<cpuFunction_t, CpuEvent *, nxs_int> {
   CpuRuntime *rt;
+  // Busy time of each team during the last dispatch
+  std::vector<nxs_long> team_busy_ns;
+
+  // Kernel argument frame built by finalize; teams copy it and only fill in
+  // the launch id, shared memory and barrier words at coords_idx..+2.
+  // Rebinding an argument of a finalized command patches its word in place;
+  // binding a new one drops the frame (coords_idx = 0) until the next
+  // finalize.
+  std::array<void *, CPU_COMMAND_MAX_FRAME> arg_frame{};
+  std::array<int32_t, 6> launch_size{};
+  int coords_idx = 0;
+
+  // Byte range and access of each buffer argument, used by CpuSchedule to
+  // find commands that may overlap; empty for scalars
+  struct BufferAccess {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    bool write = false;
+  };
+  std::array<BufferAccess, NXS_KERNEL_MAX_ARGS> buffer_access{};
+  // Bumped whenever arguments or launch dims change
+  uint32_t revision = 0;
+  // Bumped when the frame layout or launch dims change, i.e. when a launch
+  // must be prepared again rather than patched
+  uint32_t layout_revision = 0;
+
+  void patchFrame(nxs_int argument_index);
 
  public:
   CpuCommand(CpuRuntime *rt = nullptr, cpuFunction_t kernel = nullptr,
              nxs_uint command_settings = 0)
       : Command(kernel, command_settings), rt(rt) {}
 
-  CpuCommand(CpuRuntime *rt, nxs_int event, nxs_command_type type,
+  CpuCommand(CpuRuntime *rt, CpuEvent *event, nxs_command_type type,
              nxs_int event_value = 1, nxs_uint command_settings = 0)
       : Command(event, type, event_value, command_settings), rt(rt) {}
 
   ~CpuCommand() = default;
 
+  nxs_status setArgument(nxs_int argument_index, nxs::rt::Buffer *buffer,
+                         const char *name = "",
+                         nxs_uint argument_settings = 0);
+  nxs_status setScalar(nxs_int argument_index, void *value,
+                       const char *name = "", nxs_uint argument_settings = 0);
+
+  nxs_status finalize(nxs_dim3 grid_size, nxs_dim3 block_size,
+                      nxs_uint shared_memory_size);
+
+  uint32_t getRevision() const { return revision; }
+  uint32_t getLayoutRevision() const { return layout_revision; }
+
+  /// @brief True if both commands touch overlapping buffer bytes and at
+  /// least one of them writes.
+  bool conflictsWith(const CpuCommand &other) const;
+
+  /// @brief True if a buffer argument overlaps bytes [begin, end).
+  bool touches(const char *begin, const char *end) const;
+
   nxs_status runCommand(nxs_int stream) override;
 
+  nxs_status runDispatch();
+
+  /// @brief Resolve the dispatch into launch (validates and logs).
+  nxs_status prepareLaunch(CpuLaunch &launch);
+
+  /// @brief Copy rebound arguments into a launch resolved by prepareLaunch;
+  /// only valid while getLayoutRevision() is unchanged.
+  void patchLaunch(CpuLaunch &launch) const {
+    std::copy_n(arg_frame.begin(), coords_idx - 1, launch.frame.begin());
+  }
+
+  /// @brief Run a resolved dispatch on pool; the hot path shared by
+  /// runDispatch and captured replay.
+  static void execute(ThreadPool *pool, const CpuLaunch &launch);
+
+  const std::vector<nxs_long> &getTeamBusyTime() const { return team_busy_ns; }
+
   void release() override {}
 };
 
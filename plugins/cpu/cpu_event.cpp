@@ -0,0 +1,98 @@
+#include <cpu_event.h>
+#include <cpu_runtime.h>
+#include <cpu_stream.h>
+
+#include <climits>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Polls of the value before a host waiter goes to sleep.
+constexpr int kSpinCount = 1 << 8;
+
+#ifdef __linux__
+static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t),
+              "futex needs a plain 32-bit word");
+
+void futexWait(std::atomic<int32_t> *addr, int32_t expected) {
+  syscall(SYS_futex, reinterpret_cast<int32_t *>(addr), FUTEX_WAIT_PRIVATE,
+          expected, nullptr, nullptr, 0);
+}
+
+void futexWakeAll(std::atomic<int32_t> *addr) {
+  syscall(SYS_futex, reinterpret_cast<int32_t *>(addr), FUTEX_WAKE_PRIVATE,
+          INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+}  // namespace
+
+void CpuEvent::signal(nxs_int signal_value) {
+  int32_t cur = value.load(std::memory_order_relaxed);
+  while (cur < signal_value &&
+         !value.compare_exchange_weak(cur, signal_value,
+                                      std::memory_order_seq_cst)) {
+  }
+
+  if (host_waiters.load(std::memory_order_seq_cst) > 0) {
+#ifdef __linux__
+    futexWakeAll(&value);
+#else
+    std::lock_guard<std::mutex> lock(mutex);
+    host_cv.notify_all();
+#endif
+  }
+
+  // Resume parked streams outside the lock; resume may run them inline.
+  std::vector<CpuStream *> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (parked.empty()) return;
+    int32_t reached = value.load(std::memory_order_acquire);
+    auto it = parked.begin();
+    while (it != parked.end()) {
+      if (it->first <= reached) {
+        ready.push_back(it->second);
+        it = parked.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (auto *stream : ready) stream->resume();
+}
+
+void CpuEvent::wait(nxs_int wait_value) {
+  for (int spin = 0; spin < kSpinCount; ++spin) {
+    if (isReached(wait_value)) return;
+    std::this_thread::yield();
+  }
+
+  host_waiters.fetch_add(1, std::memory_order_seq_cst);
+#ifdef __linux__
+  int32_t cur;
+  while ((cur = value.load(std::memory_order_seq_cst)) < wait_value)
+    futexWait(&value, cur);
+#else
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    host_cv.wait(lock, [&] { return isReached(wait_value); });
+  }
+#endif
+  host_waiters.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+bool CpuEvent::park(nxs_int wait_value, CpuStream *stream) {
+  std::lock_guard<std::mutex> lock(mutex);
+  // signal() publishes the value before taking the lock, so checking under
+  // the lock cannot miss a concurrent signal.
+  if (isReached(wait_value)) return false;
+  parked.emplace_back(wait_value, stream);
+  return true;
+}
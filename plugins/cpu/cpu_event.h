@@ -0,0 +1,64 @@
+#ifndef RT_CPU_EVENT_H
+#define RT_CPU_EVENT_H
+
+#include <nexus-api.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class CpuStream;
+
+/************************************************************************
+ * @class CpuEvent
+ * @brief Timeline event for host and in-schedule synchronization.
+ *
+ * The event holds a monotonic 32-bit value. signal(v) advances it to v
+ * (never backwards) and wait(v) returns once it is at least v, so one
+ * event can order a whole sequence of steps. Host waiters spin briefly
+ * and then sleep on a futex (a condition variable off Linux). Streams do
+ * not block a pool worker: a stream that reaches an unsignaled wait
+ * command parks on the event and is resumed by the signal.
+ ***********************************************************************/
+class CpuEvent {
+  nxs_event_type type;
+  nxs_uint settings;
+
+  std::atomic<int32_t> value{0};
+  std::atomic<int32_t> host_waiters{0};
+
+  // Streams parked on a wait command, with the value they need
+  std::mutex mutex;
+  std::vector<std::pair<int32_t, CpuStream *>> parked;
+#ifndef __linux__
+  std::condition_variable host_cv;
+#endif
+
+ public:
+  CpuEvent(nxs_event_type type = NXS_EventType_Shared, nxs_uint settings = 0)
+      : type(type), settings(settings) {}
+
+  CpuEvent(const CpuEvent &) = delete;
+  CpuEvent &operator=(const CpuEvent &) = delete;
+
+  nxs_event_type getType() const { return type; }
+  nxs_uint getSettings() const { return settings; }
+  nxs_int getValue() const { return value.load(std::memory_order_acquire); }
+
+  bool isReached(nxs_int wait_value) const { return getValue() >= wait_value; }
+
+  /// @brief Advance the timeline to signal_value and wake waiters.
+  void signal(nxs_int signal_value);
+
+  /// @brief Block the calling thread until the value reaches wait_value.
+  void wait(nxs_int wait_value);
+
+  /// @brief Register stream to be resumed once wait_value is reached.
+  /// @return false if the value is already reached (nothing registered).
+  bool park(nxs_int wait_value, CpuStream *stream);
+};
+
+#endif  // RT_CPU_EVENT_H
@@ -0,0 +1,143 @@
+#include <cpu_library.h>
+#include <cpu_runtime.h>
+
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+bool writeAll(int fd, const void *data, size_t size) {
+  auto *bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    if (written <= 0) return false;
+    bytes += written;
+    size -= written;
+  }
+  return true;
+}
+
+// Create the backing file and the path to dlopen it by. Off Linux the
+// path is a temporary file the caller unlinks after dlopen.
+int createImageFile(char *path, size_t path_size) {
+#ifdef __linux__
+  int fd = memfd_create("nxs_cpu_library", MFD_CLOEXEC);
+  if (fd >= 0) std::snprintf(path, path_size, "/proc/self/fd/%d", fd);
+  return fd;
+#else
+  std::snprintf(path, path_size, "/tmp/nxs_cpu_library_XXXXXX");
+  return mkstemp(path);
+#endif
+}
+
+}  // namespace
+
+CpuLibraryCache::~CpuLibraryCache() {
+  for (auto &entry : images) {
+    dlclose(entry.first);
+    close(entry.second.fd);
+  }
+}
+
+uint64_t CpuLibraryCache::hashImage(const void *data, size_t size) {
+  // FNV-1a; collisions are caught by sameImage
+  uint64_t hash = 0xcbf29ce484222325ull;
+  auto *bytes = static_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+bool CpuLibraryCache::sameImage(int fd, const void *data, size_t size) {
+  void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapped == MAP_FAILED) return false;
+  bool same = std::memcmp(mapped, data, size) == 0;
+  munmap(mapped, size);
+  return same;
+}
+
+void *CpuLibraryCache::load(const void *data, size_t size) {
+  if (!data || size == 0) return nullptr;
+  uint64_t hash = hashImage(data, size);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto bucket = by_hash.find(hash);
+  if (bucket != by_hash.end()) {
+    for (void *handle : bucket->second) {
+      auto &image = images[handle];
+      if (image.size == size && sameImage(image.fd, data, size)) {
+        ++image.refs;
+        NXSAPI_LOG(nexus::NXS_LOG_NOTE, "library image reused ", handle);
+        return handle;
+      }
+    }
+  }
+
+  char path[64];
+  int fd = createImageFile(path, sizeof(path));
+  if (fd < 0) {
+    NXSAPI_LOG(nexus::NXS_LOG_ERROR, "library image: cannot create file");
+    return nullptr;
+  }
+  if (!writeAll(fd, data, size)) {
+    NXSAPI_LOG(nexus::NXS_LOG_ERROR, "library image: write failed");
+#ifndef __linux__
+    unlink(path);
+#endif
+    close(fd);
+    return nullptr;
+  }
+
+  void *handle = dlopen(path, RTLD_NOW);
+#ifndef __linux__
+  unlink(path);
+#endif
+  if (!handle) {
+    NXSAPI_LOG(nexus::NXS_LOG_ERROR, "library image: ", dlerror());
+    close(fd);
+    return nullptr;
+  }
+
+  // A library already loaded from the same file keeps its entry
+  auto it = images.find(handle);
+  if (it != images.end()) {
+    dlclose(handle);
+    close(fd);
+    ++it->second.refs;
+    return handle;
+  }
+  images[handle] = {hash, size, fd, 1};
+  by_hash[hash].push_back(handle);
+  return handle;
+}
+
+bool CpuLibraryCache::release(void *handle) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = images.find(handle);
+  if (it == images.end()) return false;
+  if (--it->second.refs == 0) {
+    auto bucket = by_hash.find(it->second.hash);
+    if (bucket != by_hash.end()) {
+      auto &handles = bucket->second;
+      handles.erase(std::find(handles.begin(), handles.end(), handle));
+      if (handles.empty()) by_hash.erase(bucket);
+    }
+    dlclose(handle);
+    close(it->second.fd);
+    images.erase(it);
+  }
+  return true;
+}
+
+size_t CpuLibraryCache::getCount() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return images.size();
+}
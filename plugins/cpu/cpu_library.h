@@ -0,0 +1,56 @@
+#ifndef RT_CPU_LIBRARY_H
+#define RT_CPU_LIBRARY_H
+
+#include <nexus-api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/************************************************************************
+ * @class CpuLibraryCache
+ * @brief Loads kernel libraries from memory images.
+ *
+ * An image is written to an anonymous memfd and dlopen'ed through
+ * /proc/self/fd, so nothing is staged on disk (platforms without memfd
+ * fall back to an unlinked temporary file). Images are keyed by a content
+ * hash; loading a byte-identical image again returns the same handle
+ * with its reference count bumped. The memfd stays open while the handle
+ * is alive so that hash matches can be confirmed byte by byte.
+ ***********************************************************************/
+class CpuLibraryCache {
+  struct Image {
+    uint64_t hash;
+    size_t size;
+    int fd;
+    int refs;
+  };
+
+  std::mutex mutex;
+  std::unordered_map<void *, Image> images;
+  // Handles by content hash; only images whose hash matches are compared
+  std::unordered_map<uint64_t, std::vector<void *>> by_hash;
+
+  static uint64_t hashImage(const void *data, size_t size);
+  static bool sameImage(int fd, const void *data, size_t size);
+
+ public:
+  CpuLibraryCache() = default;
+  ~CpuLibraryCache();
+
+  CpuLibraryCache(const CpuLibraryCache &) = delete;
+  CpuLibraryCache &operator=(const CpuLibraryCache &) = delete;
+
+  /// @brief dlopen handle for the image, or nullptr on failure.
+  void *load(const void *data, size_t size);
+
+  /// @brief Drop one reference of a handle from load().
+  /// @return false if the handle did not come from load().
+  bool release(void *handle);
+
+  size_t getCount();
+};
+
+#endif  // RT_CPU_LIBRARY_H
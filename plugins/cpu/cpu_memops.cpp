@@ -0,0 +1,334 @@
+#include "cpu_memops.h"
+
+#include <cpuinfo.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NXS_MEMOPS_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define NXS_MEMOPS_NEON 1
+#endif
+
+namespace {
+
+// Blocks are a multiple of the widest vector so every store is aligned
+constexpr size_t kBlockAlign = 64;
+constexpr size_t kMaxBlockBytes = 4096;
+
+// Store `count` copies of a block of `block_bytes` to 64B aligned `dst`
+typedef void (*StoreBlocksFn)(char *dst, const char *block,
+                              size_t block_bytes, size_t count,
+                              bool streaming);
+
+#if NXS_MEMOPS_X86
+template <bool Streaming>
+void storeSSE2(char *dst, const char *block, size_t block_bytes,
+               size_t count) {
+  for (size_t i = 0; i < count; ++i, dst += block_bytes) {
+    for (size_t off = 0; off < block_bytes; off += 16) {
+      __m128i v = _mm_load_si128((const __m128i *)(block + off));
+      if (Streaming)
+        _mm_stream_si128((__m128i *)(dst + off), v);
+      else
+        _mm_store_si128((__m128i *)(dst + off), v);
+    }
+  }
+}
+
+void storeBlocksSSE2(char *dst, const char *block, size_t block_bytes,
+                     size_t count, bool streaming) {
+  if (!streaming) return storeSSE2<false>(dst, block, block_bytes, count);
+  storeSSE2<true>(dst, block, block_bytes, count);
+  _mm_sfence();
+}
+
+template <bool Streaming>
+__attribute__((target("avx2"))) void storeAVX2(char *dst, const char *block,
+                                               size_t block_bytes,
+                                               size_t count) {
+  if (block_bytes == 64) {
+    // the common case (patterns dividing 64 bytes) stays in registers
+    __m256i lo = _mm256_load_si256((const __m256i *)block);
+    __m256i hi = _mm256_load_si256((const __m256i *)(block + 32));
+    for (size_t i = 0; i < count; ++i, dst += 64) {
+      if (Streaming) {
+        _mm256_stream_si256((__m256i *)dst, lo);
+        _mm256_stream_si256((__m256i *)(dst + 32), hi);
+      } else {
+        _mm256_store_si256((__m256i *)dst, lo);
+        _mm256_store_si256((__m256i *)(dst + 32), hi);
+      }
+    }
+    return;
+  }
+  for (size_t i = 0; i < count; ++i, dst += block_bytes) {
+    for (size_t off = 0; off < block_bytes; off += 32) {
+      __m256i v = _mm256_load_si256((const __m256i *)(block + off));
+      if (Streaming)
+        _mm256_stream_si256((__m256i *)(dst + off), v);
+      else
+        _mm256_store_si256((__m256i *)(dst + off), v);
+    }
+  }
+}
+
+__attribute__((target("avx2"))) void storeBlocksAVX2(char *dst,
+                                                     const char *block,
+                                                     size_t block_bytes,
+                                                     size_t count,
+                                                     bool streaming) {
+  if (!streaming) return storeAVX2<false>(dst, block, block_bytes, count);
+  storeAVX2<true>(dst, block, block_bytes, count);
+  _mm_sfence();
+}
+
+template <bool Streaming>
+__attribute__((target("avx512f"))) void storeAVX512(char *dst,
+                                                    const char *block,
+                                                    size_t block_bytes,
+                                                    size_t count) {
+  if (block_bytes == 64) {
+    __m512i v = _mm512_load_si512((const void *)block);
+    for (size_t i = 0; i < count; ++i, dst += 64) {
+      if (Streaming)
+        _mm512_stream_si512((__m512i *)dst, v);
+      else
+        _mm512_store_si512((void *)dst, v);
+    }
+    return;
+  }
+  for (size_t i = 0; i < count; ++i, dst += block_bytes) {
+    for (size_t off = 0; off < block_bytes; off += 64) {
+      __m512i v = _mm512_load_si512((const void *)(block + off));
+      if (Streaming)
+        _mm512_stream_si512((__m512i *)(dst + off), v);
+      else
+        _mm512_store_si512((void *)(dst + off), v);
+    }
+  }
+}
+
+__attribute__((target("avx512f"))) void storeBlocksAVX512(char *dst,
+                                                          const char *block,
+                                                          size_t block_bytes,
+                                                          size_t count,
+                                                          bool streaming) {
+  if (!streaming) return storeAVX512<false>(dst, block, block_bytes, count);
+  storeAVX512<true>(dst, block, block_bytes, count);
+  _mm_sfence();
+}
+#endif
+
+#if NXS_MEMOPS_NEON
+// NEON has no non-temporal store intrinsic; plain stores still halve the
+// store count of the scalar path
+void storeBlocksNEON(char *dst, const char *block, size_t block_bytes,
+                     size_t count, bool) {
+  for (size_t i = 0; i < count; ++i, dst += block_bytes) {
+    for (size_t off = 0; off < block_bytes; off += 64) {
+      uint8x16x4_t v = vld1q_u8_x4((const uint8_t *)(block + off));
+      vst1q_u8_x4((uint8_t *)(dst + off), v);
+    }
+  }
+}
+#elif !NXS_MEMOPS_X86
+void storeBlocksScalar(char *dst, const char *block, size_t block_bytes,
+                       size_t count, bool) {
+  for (size_t i = 0; i < count; ++i, dst += block_bytes)
+    std::memcpy(dst, block, block_bytes);
+}
+#endif
+
+#if NXS_MEMOPS_X86
+// Streaming copies walk four 4 KiB pages side by side, 128 bytes of each in
+// turn, which keeps four DRAM pages open instead of one
+constexpr size_t kCopyPage = 4096;
+constexpr size_t kCopyChunk = 4 * kCopyPage;
+
+// Stream `bytes` (a multiple of kCopyChunk) from `src` to 64B aligned `dst`
+typedef void (*StreamCopyFn)(char *dst, const char *src, size_t bytes);
+
+void streamCopySSE2(char *dst, const char *src, size_t bytes) {
+  for (size_t base = 0; base < bytes; base += kCopyChunk) {
+    for (size_t off = 0; off < kCopyPage; off += 128) {
+      for (size_t page = 0; page < kCopyChunk; page += kCopyPage) {
+        const char *s = src + base + page + off;
+        char *d = dst + base + page + off;
+        _mm_prefetch(s + 256, _MM_HINT_T0);
+        for (size_t i = 0; i < 128; i += 64) {
+          __m128i a = _mm_loadu_si128((const __m128i *)(s + i));
+          __m128i b = _mm_loadu_si128((const __m128i *)(s + i + 16));
+          __m128i c = _mm_loadu_si128((const __m128i *)(s + i + 32));
+          __m128i e = _mm_loadu_si128((const __m128i *)(s + i + 48));
+          _mm_stream_si128((__m128i *)(d + i), a);
+          _mm_stream_si128((__m128i *)(d + i + 16), b);
+          _mm_stream_si128((__m128i *)(d + i + 32), c);
+          _mm_stream_si128((__m128i *)(d + i + 48), e);
+        }
+      }
+    }
+  }
+  _mm_sfence();
+}
+
+__attribute__((target("avx2"))) void streamCopyAVX2(char *dst,
+                                                    const char *src,
+                                                    size_t bytes) {
+  for (size_t base = 0; base < bytes; base += kCopyChunk) {
+    for (size_t off = 0; off < kCopyPage; off += 128) {
+      for (size_t page = 0; page < kCopyChunk; page += kCopyPage) {
+        const char *s = src + base + page + off;
+        char *d = dst + base + page + off;
+        _mm_prefetch(s + 256, _MM_HINT_T0);
+        __m256i a = _mm256_loadu_si256((const __m256i *)s);
+        __m256i b = _mm256_loadu_si256((const __m256i *)(s + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(s + 64));
+        __m256i e = _mm256_loadu_si256((const __m256i *)(s + 96));
+        _mm256_stream_si256((__m256i *)d, a);
+        _mm256_stream_si256((__m256i *)(d + 32), b);
+        _mm256_stream_si256((__m256i *)(d + 64), c);
+        _mm256_stream_si256((__m256i *)(d + 96), e);
+      }
+    }
+  }
+  _mm_sfence();
+}
+
+__attribute__((target("avx512f"))) void streamCopyAVX512(char *dst,
+                                                         const char *src,
+                                                         size_t bytes) {
+  for (size_t base = 0; base < bytes; base += kCopyChunk) {
+    for (size_t off = 0; off < kCopyPage; off += 128) {
+      for (size_t page = 0; page < kCopyChunk; page += kCopyPage) {
+        const char *s = src + base + page + off;
+        char *d = dst + base + page + off;
+        _mm_prefetch(s + 256, _MM_HINT_T0);
+        __m512i a = _mm512_loadu_si512((const void *)s);
+        __m512i b = _mm512_loadu_si512((const void *)(s + 64));
+        _mm512_stream_si512((__m512i *)d, a);
+        _mm512_stream_si512((__m512i *)(d + 64), b);
+      }
+    }
+  }
+  _mm_sfence();
+}
+
+StreamCopyFn getStreamCopy() {
+  static const StreamCopyFn copy = []() -> StreamCopyFn {
+    cpuinfo_initialize();
+    if (cpuinfo_has_x86_avx512f()) return streamCopyAVX512;
+    if (cpuinfo_has_x86_avx2()) return streamCopyAVX2;
+    return streamCopySSE2;
+  }();
+  return copy;
+}
+#endif
+
+// Widest store kernel the processor supports, picked on first use
+StoreBlocksFn getStoreBlocks() {
+  static const StoreBlocksFn store = []() -> StoreBlocksFn {
+    cpuinfo_initialize();
+#if NXS_MEMOPS_X86
+    if (cpuinfo_has_x86_avx512f()) return storeBlocksAVX512;
+    if (cpuinfo_has_x86_avx2()) return storeBlocksAVX2;
+    return storeBlocksSSE2;
+#elif NXS_MEMOPS_NEON
+    return storeBlocksNEON;
+#else
+    return storeBlocksScalar;
+#endif
+  }();
+  return store;
+}
+
+// Write `bytes` of the pattern from `phase` on, doubling what is already
+// written; a prefix that is a whole number of patterns is always periodic
+void fillRepeat(char *dst, size_t bytes, const unsigned char *pattern,
+                size_t pattern_size, size_t phase) {
+  size_t first = std::min(bytes, pattern_size - phase);
+  std::memcpy(dst, pattern + phase, first);
+  size_t done = first;
+  if (done < bytes) {
+    size_t n = std::min(bytes - done, phase);
+    std::memcpy(dst + done, pattern, n);
+    done += n;
+  }
+  // copy from an L2-sized prefix rather than from ever further back
+  const size_t max_chunk = std::max(pattern_size, (size_t(1) << 20) /
+                                                      pattern_size *
+                                                      pattern_size);
+  while (done < bytes) {
+    size_t n = std::min({bytes - done, done, max_chunk});
+    std::memcpy(dst + done, dst, n);
+    done += n;
+  }
+}
+
+}  // namespace
+
+size_t CpuMemOps::getStreamingThreshold() {
+  static const size_t threshold = [] {
+    size_t llc = 0;
+    if (cpuinfo_initialize()) {
+      if (auto *l3 = cpuinfo_get_l3_cache(0))
+        llc = l3->size;
+      else if (auto *l2 = cpuinfo_get_l2_cache(0))
+        llc = l2->size;
+    }
+    return llc ? llc : size_t(8) << 20;
+  }();
+  return threshold;
+}
+
+void CpuMemOps::fill(void *dst_ptr, size_t bytes, const void *pattern_ptr,
+                     size_t pattern_size, size_t phase, bool streaming) {
+  if (!bytes || !pattern_size) return;
+  char *dst = static_cast<char *>(dst_ptr);
+  auto *pattern = static_cast<const unsigned char *>(pattern_ptr);
+  phase %= pattern_size;
+
+  if (std::all_of(pattern + 1, pattern + pattern_size,
+                  [&](unsigned char c) { return c == pattern[0]; })) {
+    std::memset(dst, pattern[0], bytes);
+    return;
+  }
+  size_t block_bytes = std::lcm(pattern_size, kBlockAlign);
+  if (block_bytes > kMaxBlockBytes || bytes < block_bytes + kBlockAlign)
+    return fillRepeat(dst, bytes, pattern, pattern_size, phase);
+
+  // unaligned head, after which the pattern continues at a new phase
+  size_t head = (kBlockAlign - (uintptr_t)dst % kBlockAlign) % kBlockAlign;
+  fillRepeat(dst, head, pattern, pattern_size, phase);
+  dst += head;
+  bytes -= head;
+  phase = (phase + head) % pattern_size;
+
+  alignas(kBlockAlign) char block[kMaxBlockBytes];
+  fillRepeat(block, block_bytes, pattern, pattern_size, phase);
+  size_t count = bytes / block_bytes;
+  getStoreBlocks()(dst, block, block_bytes, count, streaming);
+  std::memcpy(dst + count * block_bytes, block, bytes % block_bytes);
+}
+
+void CpuMemOps::copy(void *dst_ptr, const void *src_ptr, size_t bytes,
+                     bool streaming) {
+#if NXS_MEMOPS_X86
+  if (streaming && bytes >= kCopyChunk + kBlockAlign) {
+    char *dst = static_cast<char *>(dst_ptr);
+    const char *src = static_cast<const char *>(src_ptr);
+    size_t head = (kBlockAlign - (uintptr_t)dst % kBlockAlign) % kBlockAlign;
+    std::memcpy(dst, src, head);
+    size_t body = (bytes - head) / kCopyChunk * kCopyChunk;
+    getStreamCopy()(dst + head, src + head, body);
+    std::memcpy(dst + head + body, src + head + body, bytes - head - body);
+    return;
+  }
+#endif
+  std::memcpy(dst_ptr, src_ptr, bytes);
+}
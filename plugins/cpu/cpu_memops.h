@@ -0,0 +1,41 @@
+#ifndef RT_CPU_MEMOPS_H
+#define RT_CPU_MEMOPS_H
+
+#include <cstddef>
+
+/************************************************************************
+ * @class CpuMemOps
+ * @brief Bulk memory kernels behind the CPU buffer entry points.
+ *
+ * Fills repeat a pattern of any size. Patterns whose bytes are all equal
+ * go to memset; everything else is expanded once into a 64B aligned block
+ * (the pattern repeated to a multiple of 64 bytes) that is stored over the
+ * destination with the widest vector unit the processor has (AVX-512,
+ * AVX2, SSE2 or NEON, picked at load time). Fills larger than the last
+ * level cache use non-temporal stores so they do not evict the working
+ * set. Copies above the same threshold stream the destination with
+ * unaligned vector loads and aligned non-temporal stores; smaller ones are
+ * left to memcpy, which wins while the data stays cached. Splitting large
+ * fills and copies across the worker pool is up to the caller; `phase`
+ * lets each fill stripe continue the pattern where the previous one
+ * stopped.
+ ***********************************************************************/
+class CpuMemOps {
+ public:
+  /// @brief Bytes above which bulk stores bypass the cache: the size of
+  /// the last level cache as reported by cpuinfo.
+  static size_t getStreamingThreshold();
+
+  /// @brief Fill [dst, dst + bytes) with `pattern` repeated, starting at
+  /// byte `phase` of the pattern; `streaming` selects non-temporal stores.
+  static void fill(void *dst, size_t bytes, const void *pattern,
+                   size_t pattern_size, size_t phase = 0,
+                   bool streaming = false);
+
+  /// @brief Copy `bytes` from `src` to `dst` (which must not overlap);
+  /// `streaming` selects non-temporal stores.
+  static void copy(void *dst, const void *src, size_t bytes,
+                   bool streaming = false);
+};
+
+#endif  // RT_CPU_MEMOPS_H
@@ -1,4 +1,5 @@
 #include "cpu_runtime.h"
+#include "cpu_scratch.h"
 
 #include <assert.h>
 #include <dlfcn.h>
@@ -12,8 +13,13 @@
 #include <functional>
 #include <magic_enum/magic_enum.hpp>
 #include <optional>
+#include <string_view>
 #include <vector>
 
+#if defined(__linux__)
+#include <link.h>
+#endif
+
 #define NXSAPI_LOG_MODULE "cpu_runtime"
 
 using namespace nxs;
@@ -26,6 +32,32 @@ CpuRuntime *getRuntime() {
 #undef NXS_API_CALL
 #define NXS_API_CALL __attribute__((visibility("default")))
 
+/// @brief Check whether a loaded kernel library imports _cpu_barrier.
+/// Scans the dynamic string table; assumes the barrier is used when the
+/// table is not available.
+static bool libraryUsesBarrier(void *lib) {
+#if defined(__linux__)
+  struct link_map *map = nullptr;
+  if (dlinfo(lib, RTLD_DI_LINKMAP, &map) != 0 || !map) return true;
+  const char *strtab = nullptr;
+  size_t strsz = 0;
+  for (const ElfW(Dyn) *dyn = map->l_ld; dyn->d_tag != DT_NULL; ++dyn) {
+    if (dyn->d_tag == DT_STRTAB)
+      strtab = reinterpret_cast<const char *>(dyn->d_un.d_ptr);
+    else if (dyn->d_tag == DT_STRSZ)
+      strsz = dyn->d_un.d_val;
+  }
+  if (!strtab || !strsz) return true;
+  // some targets keep the dynamic section unrelocated
+  if (reinterpret_cast<ElfW(Addr)>(strtab) < map->l_addr) strtab += map->l_addr;
+  static constexpr char symbol[] = "\0_cpu_barrier";
+  return std::string_view(strtab, strsz).find(
+             std::string_view(symbol, sizeof(symbol))) != std::string_view::npos;
+#else
+  return true;
+#endif
+}
+
 /************************************************************************
  * @def GetRuntimeProperty
  * @brief Return Runtime properties
@@ -44,13 +76,22 @@ nxsGetRuntimeProperty(nxs_uint runtime_property_id, void *property_value,
   /* lookup HIP equivalent */
   /* return value size */
   /* return value */
+  static const nxs_long keys[] = {NP_Name, NP_Type, NP_Vendor, NP_Size, NP_ID,
+                                  NP_ScratchMemoryUsed, NP_ScratchMemoryPeak,
+                                  NP_ScratchMemorySize, NP_BufferCacheSize,
+                                  NP_BufferCacheLimit, NP_BufferCacheHitRate,
+                                  NP_BufferCacheFragmentation};
+  const int keys_count = sizeof(keys) / sizeof(keys[0]);
   switch (runtime_property_id) {
-    case NP_Keys: {
-      nxs_long keys[] = {NP_Name, NP_Type, NP_Vendor, NP_Size, NP_ID};
-      int keys_count = sizeof(keys) / sizeof(keys[0]);
+    case NP_Keys:
       return rt::getPropertyVec(property_value, property_value_size, keys,
                                 keys_count);
-    }
+    case NP_Values:
+      return rt::getPropertyValues(
+          property_value, property_value_size, keys, keys_count,
+          [](nxs_long key, void *value, size_t *size) {
+            return nxsGetRuntimeProperty(key, value, size);
+          });
     case NP_Name:
       return rt::getPropertyStr(property_value, property_value_size, "cpu");
     case NP_Size:
@@ -67,6 +108,27 @@ nxsGetRuntimeProperty(nxs_uint runtime_property_id, void *property_value,
       return rt::getPropertyInt(property_value, property_value_size,
                                 cpuinfo_has_arm_sme2() ? 1 : 0);
     }
+    case NP_ScratchMemoryUsed:
+      return rt::getPropertyInt(property_value, property_value_size,
+                                rt->getScratch()->getUsed());
+    case NP_ScratchMemoryPeak:
+      return rt::getPropertyInt(property_value, property_value_size,
+                                rt->getScratch()->getPeak());
+    case NP_ScratchMemorySize:
+      return rt::getPropertyInt(property_value, property_value_size,
+                                rt->getScratch()->getReserved());
+    case NP_BufferCacheSize:
+      return rt::getPropertyInt(property_value, property_value_size,
+                                rt->getBufferCache()->getCachedBytes());
+    case NP_BufferCacheLimit:
+      return rt::getPropertyInt(property_value, property_value_size,
+                                rt->getBufferCache()->getLimit());
+    case NP_BufferCacheHitRate:
+      return rt::getPropertyFlt(property_value, property_value_size,
+                                rt->getBufferCache()->getHitRate());
+    case NP_BufferCacheFragmentation:
+      return rt::getPropertyFlt(property_value, property_value_size,
+                                rt->getBufferCache()->getFragmentation());
     default:
       return NXS_InvalidProperty;
   }
@@ -87,11 +149,16 @@ nxsGetDeviceProperty(nxs_int device_id, nxs_uint device_property_id,
   auto *arch = cpuinfo_get_uarch(device_id);
   // auto isa = device->core->isa;
 
+  static const nxs_long keys[] = {NP_Name, NP_Type, NP_Architecture, NP_Size};
   switch (device_property_id) {
-    case NP_Keys: {
-      nxs_long keys[] = {NP_Name, NP_Type, NP_Architecture, NP_Size};
+    case NP_Keys:
       return rt::getPropertyVec(property_value, property_value_size, keys, 4);
-    }
+    case NP_Values:
+      return rt::getPropertyValues(
+          property_value, property_value_size, keys, 4,
+          [&](nxs_long key, void *value, size_t *size) {
+            return nxsGetDeviceProperty(device_id, key, value, size);
+          });
     case NP_Name: {
       // return getStr(property_value, property_value_size, device->core);
     }
@@ -132,6 +199,23 @@ extern "C" nxs_int NXS_API_CALL nxsCreateBuffer(nxs_int device_id, nxs_buffer_la
   return rt->addObject(buf);
 }
 
+/************************************************************************
+ * @def CreateSubBuffer
+ * @brief Create a view of a buffer sharing its memory
+ * @return Error status or Succes.
+ ***********************************************************************/
+extern "C" nxs_int NXS_API_CALL nxsCreateSubBuffer(nxs_int buffer_id,
+                                                   nxs_ulong offset,
+                                                   nxs_buffer_layout shape,
+                                                   nxs_uint settings) {
+  auto rt = getRuntime();
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "createSubBuffer ", buffer_id, " @", offset);
+  auto *buf = rt->getSubBuffer(buffer_id, offset, shape, settings);
+  if (!buf) return NXS_InvalidBuffer;
+
+  return rt->addObject(buf);
+}
+
 /************************************************************************
  * @def GetBufferProperty
  * @brief Return Buffer properties
@@ -144,21 +228,40 @@ extern "C" nxs_int NXS_API_CALL nxsCreateBuffer(nxs_int device_id, nxs_buffer_la
   if (!buffer) return NXS_InvalidBuffer;
   auto bufObj = (*buffer)->get<rt::Buffer>();
 
+  static const nxs_long keys[] = {NP_Name,      NP_Type,     NP_Shape,
+                                  NP_Size,      NP_Value,    NP_Alignment,
+                                  NP_PageSize,  NP_Placement, NP_Offset};
   switch (buffer_property_id) {
-    case NP_Keys: {
-      nxs_long keys[] = {NP_Name, NP_Type, NP_Shape, NP_Size, NP_Value};
-      return rt::getPropertyVec(property_value, property_value_size, keys, 5);
-    }
+    case NP_Keys:
+      return rt::getPropertyVec(property_value, property_value_size, keys, 9);
+    case NP_Values:
+      return rt::getPropertyValues(
+          property_value, property_value_size, keys, 9,
+          [&](nxs_long key, void *value, size_t *size) {
+            return nxsGetBufferProperty(buffer_id, key, value, size);
+          });
+    case NP_Offset:
+      return rt::getPropertyInt(property_value, property_value_size,
+                                bufObj->getOffset());
     case NP_Value:
       return rt::getPropertyInt(property_value, property_value_size,
                                 reinterpret_cast<nxs_long>(bufObj->getData()));
+    case NP_Alignment:
+      return rt::getPropertyInt(property_value, property_value_size,
+                                bufObj->getAlignment());
+    case NP_PageSize:
+      return rt::getPropertyInt(property_value, property_value_size,
+                                bufObj->getPageSize());
+    case NP_Placement:
+      return rt::getPropertyStr(property_value, property_value_size,
+                                bufObj->getPlacementName());
   }
   return NXS_InvalidProperty;
 }
 
 /************************************************************************
  * @def CopyBuffer
- * @brief Copy a buffer to the host
+ * @brief Copy a buffer to or from the host
  * @return Error status or Succes.
  ***********************************************************************/
 extern "C" nxs_status NXS_API_CALL nxsCopyBuffer(nxs_int buffer_id,
@@ -168,7 +271,66 @@ extern "C" nxs_status NXS_API_CALL nxsCopyBuffer(nxs_int buffer_id,
   auto buf = rt->getObject(buffer_id);
   if (!buf) return NXS_InvalidBuffer;
   auto bufObj = (*buf)->get<rt::Buffer>();
-  std::memcpy(host_ptr, bufObj->data(), bufObj->getSizeBytes());
+  rt->waitStreams(bufObj);
+  return rt->copyBuffer(bufObj, host_ptr, settings, 0,
+                        bufObj->getSizeBytes());
+}
+
+/************************************************************************
+ * @def CopyBufferRegion
+ * @brief Copy a region between buffers or between a buffer and the host
+ * @return Error status or Succes.
+ ***********************************************************************/
+extern "C" nxs_status NXS_API_CALL
+nxsCopyBufferRegion(nxs_int src_buffer_id, nxs_int dst_buffer_id,
+                    void *host_ptr, const nxs_buffer_region *region,
+                    nxs_uint settings) {
+  auto rt = getRuntime();
+  if (!region || region->rank == 0 || region->rank > NXS_MAX_DIMS)
+    return NXS_InvalidValue;
+
+  // last byte the region touches past its offset, on either side
+  size_t src_span = region->extent[0], dst_span = region->extent[0];
+  size_t rows = 1;
+  for (nxs_uint d = 1; d < region->rank; ++d) {
+    if (region->extent[d] == 0) return NXS_Success;
+    rows *= region->extent[d];
+    src_span += (region->extent[d] - 1) * region->src_stride[d];
+    dst_span += (region->extent[d] - 1) * region->dst_stride[d];
+  }
+  if (region->extent[0] == 0) return NXS_Success;
+
+  auto resolve = [&](nxs_int buffer_id, size_t offset, size_t span,
+                     char *&ptr) -> nxs_status {
+    if (!nxs_valid_id(buffer_id)) {
+      if (!host_ptr) return NXS_InvalidHostPtr;
+      ptr = static_cast<char *>(host_ptr) + offset;
+      return NXS_Success;
+    }
+    auto buffer = rt->get<rt::Buffer>(buffer_id);
+    if (!buffer) return NXS_InvalidBuffer;
+    size_t extent = buffer->getExtentBytes();
+    if (offset > extent || span > extent - offset)
+      return NXS_InvalidBufferSize;
+    ptr = buffer->data() + offset;
+    return NXS_Success;
+  };
+  char *src = nullptr, *dst = nullptr;
+  if (!nxs_valid_id(src_buffer_id) && !nxs_valid_id(dst_buffer_id))
+    return NXS_InvalidBuffer;
+  auto status = resolve(src_buffer_id, region->src_offset, src_span, src);
+  if (!nxs_success(status)) return status;
+  status = resolve(dst_buffer_id, region->dst_offset, dst_span, dst);
+  if (!nxs_success(status)) return status;
+  // only a single range may overlap itself (it is moved)
+  if (rows > 1 && dst < src + src_span && src < dst + dst_span)
+    return NXS_MemCopyOverlap;
+
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "copyBufferRegion ", src_buffer_id, " -> ",
+             dst_buffer_id);
+  rt->waitStreams(src, src + src_span);
+  rt->waitStreams(dst, dst + dst_span);
+  rt->copyRegion(dst, src, *region);
   return NXS_Success;
 }
 
@@ -183,35 +345,16 @@ extern "C" nxs_status NXS_API_CALL nxsCopyBuffer(nxs_int buffer_id,
   auto rt = getRuntime();
   auto buffer = rt->get<rt::Buffer>(buffer_id);
   if (!buffer || value_size == 0) return NXS_InvalidBuffer;
+  rt->waitStreams(buffer);
 
-  size_t total_size = buffer->getSizeBytes();
-
-  bool is_zero = true;
-  for (nxs_uint i = 0; i < value_size; ++i) {
-    if (*((unsigned char*)value + i) != 0) {
-      is_zero = false;
-      break;
-    }
-  }
-
-  char *buffer_data = buffer->data();
-  if (is_zero || value_size == 1) {
-    std::memset(buffer_data, *((unsigned char*)value), total_size);
-    return NXS_Success;
-  }
-
-  assert(total_size % value_size == 0 && "Buffer size must be aligned with value size");
-  if (value_size == 2) {
-    uint16_t val = *((uint16_t*)value);
-    auto* ptr = reinterpret_cast<uint16_t*>(buffer_data);
-    std::fill(ptr, ptr + total_size / 2, val);
-  } else if (value_size == 4) {
-    uint32_t val = *((uint32_t*)value);
-    auto* ptr = reinterpret_cast<uint32_t*>(buffer_data);
-    std::fill(ptr, ptr + total_size / 4, val);
-  } else {
-    assert(false && "Unsupported value size");
-  }
+  // large fills stream past the cache; views fill one run at a time with
+  // the pattern continuing across runs
+  bool streaming =
+      buffer->getSizeBytes() >= CpuMemOps::getStreamingThreshold();
+  auto fill_run = [&](char *run, size_t bytes, size_t packed) {
+    rt->fill(run, bytes, value, value_size, packed, streaming);
+  };
+  if (!buffer->forEachRun(fill_run)) return NXS_InvalidBuffer;
 
   return NXS_Success;
 }
@@ -236,20 +379,16 @@ extern "C" nxs_int NXS_API_CALL nxsCreateLibrary(nxs_int device_id,
                                                  void *library_data,
                                                  nxs_uint data_size,
                                                  nxs_uint settings) {
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "createLibrary ", device_id, " - ",
+             data_size);
   auto rt = getRuntime();
   auto dev = rt->getObject(device_id);
   if (!dev) return NXS_InvalidDevice;
 
-  // #include <sys/mman.h>
-  // #include <dlfcn.h>
-  // #include <unistd.h>
-  // int fd = memfd_create("my_lib", MFD_CLOEXEC);
-  // write(fd, library_data, library_size);
-  // char fd_path[64];
-  // snprintf(fd_path, sizeof(fd_path), "/proc/self/fd/%d", fd);
-  // void *handle = dlopen(fd_path, RTLD_NOW);
-  // return rt->addObject(lib);
-  return NXS_InvalidLibrary;
+  // Loaded from an in-memory file; identical images share one handle
+  void *lib = rt->getLibraryCache()->load(library_data, data_size);
+  if (!lib) return NXS_InvalidLibrary;
+  return rt->addObject(lib);
 }
 
 /************************************************************************
@@ -280,7 +419,24 @@ extern "C" nxs_int NXS_API_CALL nxsCreateLibraryFromFile(
 extern "C" nxs_status NXS_API_CALL
 nxsGetLibraryProperty(nxs_int library_id, nxs_uint library_property_id,
                       void *property_value, size_t *property_value_size) {
-  return NXS_InvalidProperty;
+  auto rt = getRuntime();
+  auto lib = rt->get<void>(library_id);
+  if (!lib) return NXS_InvalidLibrary;
+
+  switch (library_property_id) {
+    case NP_Keys: {
+      constexpr nxs_long keys[] = {NP_Value};
+      constexpr int keys_count = sizeof(keys) / sizeof(keys[0]);
+      return rt::getPropertyVec(property_value, property_value_size, keys,
+                                keys_count);
+    }
+    case NP_Value:
+      // dlopen handle; equal for deduplicated images
+      return rt::getPropertyInt(property_value, property_value_size,
+                                (nxs_long)lib);
+    default:
+      return NXS_InvalidProperty;
+  }
 }
 
 /************************************************************************
@@ -292,7 +448,8 @@ extern "C" nxs_status NXS_API_CALL nxsReleaseLibrary(nxs_int library_id) {
   auto rt = getRuntime();
   auto lib = rt->getObject(library_id);
   if (!lib) return NXS_InvalidLibrary;
-  dlclose((*lib)->get<void>());
+  void *handle = (*lib)->get<void>();
+  if (!rt->getLibraryCache()->release(handle)) dlclose(handle);
   rt->dropObject(library_id);
   return NXS_Success;
 }
@@ -314,7 +471,13 @@ extern "C" nxs_int NXS_API_CALL nxsGetKernel(nxs_int library_id,
     NXSAPI_LOG(nexus::NXS_LOG_ERROR, "getKernel ", dlerror());
     return NXS_InvalidKernel;
   }
-  return rt->addObject(func);
+  nxs_int kernel_id = rt->addObject(func);
+  if (kernel_id >= 0 && !libraryUsesBarrier((*lib)->get<void>())) {
+    NXSAPI_LOG(nexus::NXS_LOG_NOTE, "getKernel ", kernel_name,
+               " - barrier free");
+    rt->setBarrierFree(kernel_id);
+  }
+  return kernel_id;
 }
 
 /************************************************************************
@@ -343,10 +506,93 @@ nxsGetKernelProperty(nxs_int kernel_id, nxs_uint kernel_property_id,
  ***********************************************************************/
 extern "C" nxs_status NXS_API_CALL nxsReleaseKernel(nxs_int kernel_id) {
   auto rt = getRuntime();
-  if (!rt->dropObject(kernel_id)) return NXS_InvalidKernel;
+  return rt->releaseKernel(kernel_id);
+}
+
+/************************************************************************
+ * @def CreateEvent
+ * @brief Create a timeline event on the device
+ * @return Negative value is an error status.
+ *         Non-negative is the eventId.
+ ***********************************************************************/
+extern "C" nxs_int NXS_API_CALL nxsCreateEvent(nxs_int device_id,
+                                               nxs_event_type event_type,
+                                               nxs_uint event_settings) {
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "createEvent ", event_type);
+  auto rt = getRuntime();
+  auto dev = rt->getObject(device_id);
+  if (!dev) return NXS_InvalidDevice;
+
+  return rt->getEvent(event_type, event_settings);
+}
+
+/************************************************************************
+ * @def GetEventProperty
+ * @brief Return Event properties
+ ***********************************************************************/
+extern "C" nxs_status NXS_API_CALL
+nxsGetEventProperty(nxs_int event_id, nxs_uint event_property_id,
+                    void *property_value, size_t *property_value_size) {
+  auto rt = getRuntime();
+  auto event = rt->get<CpuEvent>(event_id);
+  if (!event) return NXS_InvalidEvent;
+
+  switch (event_property_id) {
+    case NP_Keys: {
+      constexpr nxs_long keys[] = {NP_Value};
+      constexpr int keys_count = sizeof(keys) / sizeof(keys[0]);
+      return rt::getPropertyVec(property_value, property_value_size, keys,
+                                keys_count);
+    }
+    case NP_Value:
+      return rt::getPropertyInt(property_value, property_value_size,
+                                event->getValue());
+    default:
+      return NXS_InvalidProperty;
+  }
+  return NXS_Success;
+}
+
+/************************************************************************
+ * @def SignalEvent
+ * @brief Advance the event to signal_value from the host
+ ***********************************************************************/
+extern "C" nxs_status NXS_API_CALL nxsSignalEvent(nxs_int event_id,
+                                                  nxs_int signal_value) {
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "signalEvent ", event_id, " - ",
+             signal_value);
+  auto rt = getRuntime();
+  auto event = rt->get<CpuEvent>(event_id);
+  if (!event) return NXS_InvalidEvent;
+  event->signal(signal_value);
+  return NXS_Success;
+}
+
+/************************************************************************
+ * @def WaitEvent
+ * @brief Block the host until the event reaches wait_value
+ ***********************************************************************/
+extern "C" nxs_status NXS_API_CALL nxsWaitEvent(nxs_int event_id,
+                                                nxs_int wait_value) {
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "waitEvent ", event_id, " - ", wait_value);
+  auto rt = getRuntime();
+  auto event = rt->get<CpuEvent>(event_id);
+  if (!event) return NXS_InvalidEvent;
+  event->wait(wait_value);
   return NXS_Success;
 }
 
+/************************************************************************
+ * @def ReleaseEvent
+ * @brief Release the event on the device
+ * @return Error status or Succes.
+ ***********************************************************************/
+extern "C" nxs_status NXS_API_CALL nxsReleaseEvent(nxs_int event_id) {
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "releaseEvent ", event_id);
+  auto rt = getRuntime();
+  return rt->releaseEvent(event_id);
+}
+
 /************************************************************************
  * @def CreateStream
  * @brief Create stream on the device
@@ -359,8 +605,9 @@ extern "C" nxs_int NXS_API_CALL nxsCreateStream(nxs_int device_id,
   auto dev = rt->getObject(device_id);
   if (!dev) return NXS_InvalidDevice;
 
-  // 1 CPU, with many cores and 1 thread per core
-  return NXS_Success;
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "createStream");
+  // Each stream is an in-order queue drained on the shared thread pool
+  return rt->getStream(stream_settings);
 }
 
 /************************************************************************
@@ -369,10 +616,9 @@ extern "C" nxs_int NXS_API_CALL nxsCreateStream(nxs_int device_id,
  * @return Error status or Succes.
  ***********************************************************************/
 extern "C" nxs_status NXS_API_CALL nxsReleaseStream(nxs_int stream_id) {
-  // auto rt = getRuntime();
-  // if (!rt->dropObject<MTL::CommandQueue>(stream_id))
-  //   return NXS_InvalidStream;
-  return NXS_Success;
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "releaseStream ", stream_id);
+  auto rt = getRuntime();
+  return rt->releaseStream(stream_id);
 }
 
 /************************************************************************
@@ -405,7 +651,7 @@ nxsGetScheduleProperty(nxs_int schedule_id, nxs_uint schedule_property_id,
 
   switch (schedule_property_id) {
     case NP_Keys: {
-      constexpr nxs_long keys[] = {NP_ElapsedTime};
+      constexpr nxs_long keys[] = {NP_ElapsedTime, NP_StepCount};
       constexpr int keys_count = sizeof(keys) / sizeof(keys[0]);
       return rt::getPropertyVec(property_value, property_value_size, keys,
                                 keys_count);
@@ -414,6 +660,10 @@ nxsGetScheduleProperty(nxs_int schedule_id, nxs_uint schedule_property_id,
       return rt::getPropertyFlt(property_value, property_value_size,
                                 schedule->getTime());
     }
+    case NP_StepCount: {
+      return rt::getPropertyInt(property_value, property_value_size,
+                                schedule->getStepCount());
+    }
   }
   return NXS_Success;
 }
@@ -430,7 +680,15 @@ extern "C" nxs_status NXS_API_CALL nxsRunSchedule(nxs_int schedule_id,
   auto schedule = rt->get<CpuSchedule>(schedule_id);
   if (!schedule) return NXS_InvalidSchedule;
 
-  return schedule->run(stream_id, run_settings);
+  // Without a stream the schedule runs synchronously on the caller, after
+  // whatever the streams still have queued
+  auto stream = rt->get<CpuStream>(stream_id);
+  if (!stream) {
+    rt->waitStreams();
+    return schedule->run(stream_id, run_settings);
+  }
+
+  return stream->enqueue(schedule, stream_id, run_settings);
 }
 
 /************************************************************************
@@ -449,6 +707,21 @@ extern "C" nxs_status NXS_API_CALL nxsReleaseSchedule(nxs_int schedule_id) {
  * @return Negative value is an error status.
  *         Non-negative is the bufferId.
  ***********************************************************************/
+/// @brief Settings of a kernel command: the kernel's barrier use and, unless
+/// given, the block scheduling mode of the schedule.
+static nxs_uint getDispatchSettings(CpuRuntime *rt, CpuSchedule *schedule,
+                                    nxs_int kernel_id, nxs_uint settings) {
+  if (rt->isBarrierFree(kernel_id)) settings |= NXS_CommandSettings_BarrierFree;
+
+  // inherit the block scheduling mode from the schedule
+  if (!(settings & NXS_CommandSettings_ScheduleMask)) {
+    constexpr nxs_uint chunk_mask = ~0u << NXS_CommandSettings_ChunkSizeShift;
+    settings |= schedule->getSettings() &
+                (NXS_CommandSettings_ScheduleMask | chunk_mask);
+  }
+  return settings;
+}
+
 extern "C" nxs_int NXS_API_CALL nxsCreateCommand(nxs_int schedule_id,
                                                  nxs_int kernel_id,
                                                  nxs_uint settings) {
@@ -459,9 +732,134 @@ extern "C" nxs_int NXS_API_CALL nxsCreateCommand(nxs_int schedule_id,
   if (!kernel_v) return NXS_InvalidKernel;
   auto kernel = reinterpret_cast<cpuFunction_t>(kernel_v);
 
+  settings = getDispatchSettings(rt, schedule, kernel_id, settings);
   auto command = rt->getCommand(kernel, settings);
-  schedule->addCommand(command);
-  return rt->addObject(command);
+  if (!command) return NXS_InvalidCommand;
+  return rt->addCommand(schedule, command);
+}
+
+/************************************************************************
+ * @def CreateDispatch
+ * @brief Create a kernel command with its arguments and launch dims
+ * @return Negative value is an error status.
+ *         Non-negative is the commandId.
+ ***********************************************************************/
+extern "C" nxs_int NXS_API_CALL nxsCreateDispatch(
+    nxs_int schedule_id, nxs_int kernel_id, const nxs_command_arg *args,
+    nxs_uint arg_count, nxs_dim3 grid_size, nxs_dim3 block_size,
+    nxs_uint shared_memory_size, nxs_uint settings) {
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "createDispatch ", kernel_id, " - ",
+             arg_count, " args");
+  auto rt = getRuntime();
+  auto schedule = rt->get<CpuSchedule>(schedule_id);
+  if (!schedule) return NXS_InvalidSchedule;
+  auto kernel_v = rt->get<void>(kernel_id);
+  if (!kernel_v) return NXS_InvalidKernel;
+  if (arg_count > NXS_KERNEL_MAX_ARGS) return NXS_InvalidArgIndex;
+  if (arg_count && !args) return NXS_InvalidArgValue;
+  auto kernel = reinterpret_cast<cpuFunction_t>(kernel_v);
+
+  settings = getDispatchSettings(rt, schedule, kernel_id, settings);
+  auto command = rt->getCommand(kernel, settings);
+  if (!command) return NXS_InvalidCommand;
+
+  // Build the command before it is visible; a failure leaves no trace
+  nxs_status status = NXS_Success;
+  for (nxs_uint i = 0; i < arg_count && nxs_success(status); ++i) {
+    auto &arg = args[i];
+    const char *name = arg.name ? arg.name : "";
+    if (nxs_valid_id(arg.buffer_id) || !arg.value) {
+      auto buffer = rt->get<rt::Buffer>(arg.buffer_id);
+      status = buffer ? command->setArgument(i, buffer, name, arg.settings)
+                      : NXS_InvalidBuffer;
+    } else {
+      status = command->setScalar(i, arg.value, name, arg.settings);
+    }
+  }
+  if (nxs_success(status))
+    status = command->finalize(grid_size, block_size, shared_memory_size);
+  if (!nxs_success(status)) {
+    rt->discardCommand(command);
+    return status;
+  }
+  return rt->addCommand(schedule, command);
+}
+
+/************************************************************************
+ * @def CreateSignalCommand
+ * @brief Create command that signals an event when the schedule reaches it
+ * @return Negative value is an error status.
+ *         Non-negative is the commandId.
+ ***********************************************************************/
+extern "C" nxs_int NXS_API_CALL
+nxsCreateSignalCommand(nxs_int schedule_id, nxs_int event_id,
+                       nxs_int signal_value, nxs_uint command_settings) {
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "createSignalCommand ", schedule_id, " - ",
+             event_id, " - ", signal_value);
+  auto rt = getRuntime();
+  auto schedule = rt->get<CpuSchedule>(schedule_id);
+  if (!schedule) return NXS_InvalidSchedule;
+  auto event = rt->get<CpuEvent>(event_id);
+  if (!event) return NXS_InvalidEvent;
+
+  auto command = rt->getCommand(event, NXS_CommandType_Signal, signal_value,
+                                command_settings);
+  if (!command) return NXS_InvalidCommand;
+  return rt->addCommand(schedule, command);
+}
+
+/************************************************************************
+ * @def CreateWaitCommand
+ * @brief Create command that holds the schedule until an event is reached
+ * @return Negative value is an error status.
+ *         Non-negative is the commandId.
+ ***********************************************************************/
+extern "C" nxs_int NXS_API_CALL
+nxsCreateWaitCommand(nxs_int schedule_id, nxs_int event_id, nxs_int wait_value,
+                     nxs_uint command_settings) {
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "createWaitCommand ", schedule_id, " - ",
+             event_id, " - ", wait_value);
+  auto rt = getRuntime();
+  auto schedule = rt->get<CpuSchedule>(schedule_id);
+  if (!schedule) return NXS_InvalidSchedule;
+  auto event = rt->get<CpuEvent>(event_id);
+  if (!event) return NXS_InvalidEvent;
+
+  auto command = rt->getCommand(event, NXS_CommandType_Wait, wait_value,
+                                command_settings);
+  if (!command) return NXS_InvalidCommand;
+  return rt->addCommand(schedule, command);
+}
+
+/************************************************************************
+ * @def GetCommandProperty
+ * @brief Return Command properties
+ ***********************************************************************/
+extern "C" nxs_status NXS_API_CALL
+nxsGetCommandProperty(nxs_int command_id, nxs_uint command_property_id,
+                      void *property_value, size_t *property_value_size) {
+  auto rt = getRuntime();
+  auto command = rt->get<CpuCommand>(command_id);
+  if (!command) return NXS_InvalidCommand;
+
+  switch (command_property_id) {
+    case NP_Keys: {
+      constexpr nxs_long keys[] = {NP_ElapsedTime, NP_TeamBusyTime};
+      constexpr int keys_count = sizeof(keys) / sizeof(keys[0]);
+      return rt::getPropertyVec(property_value, property_value_size, keys,
+                                keys_count);
+    }
+    case NP_ElapsedTime: {
+      return rt::getPropertyFlt(property_value, property_value_size,
+                                command->getTime());
+    }
+    case NP_TeamBusyTime: {
+      auto &busy = command->getTeamBusyTime();
+      return rt::getPropertyVec(property_value, property_value_size,
+                                busy.data(), busy.size());
+    }
+  }
+  return NXS_InvalidProperty;
 }
 
 /************************************************************************
@@ -522,3 +920,23 @@ extern "C" nxs_status NXS_API_CALL nxsFinalizeCommand(nxs_int command_id,
 
   return command->finalize(grid_size, group_size, shared_memory_size);
 }
+
+/************************************************************************
+ * @def ReleaseCommand
+ * @brief Remove a kernel command from its schedule and release it
+ * @return Error status or Succes.
+ ***********************************************************************/
+extern "C" nxs_status NXS_API_CALL nxsReleaseCommand(nxs_int schedule_id,
+                                                    nxs_int command_id) {
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "releaseCommand ", command_id);
+  auto rt = getRuntime();
+  auto schedule = rt->get<CpuSchedule>(schedule_id);
+  if (!schedule) return NXS_InvalidSchedule;
+  auto command = rt->get<CpuCommand>(command_id);
+  if (!command) return NXS_InvalidCommand;
+
+  // a queued run of the schedule may still use it
+  rt->waitStreams(schedule);
+  if (!schedule->removeCommand(command, command_id)) return NXS_InvalidCommand;
+  return rt->releaseCommand(command_id);
+}
@@ -1,9 +1,15 @@
 #ifndef RT_CPU_RUNTIME_H
 #define RT_CPU_RUNTIME_H
 
+#include <cpu_buffer_cache.h>
 #include <cpu_command.h>
+#include <cpu_event.h>
+#include <cpu_library.h>
+#include <cpu_memops.h>
 #include <cpu_runtime.h>
 #include <cpu_schedule.h>
+#include <cpu_scratch.h>
+#include <cpu_stream.h>
 #include <cpuinfo.h>
 #include <rt_runtime.h>
 
@@ -13,14 +19,77 @@
 
 #include "threadpool.h"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
 using namespace nxs;
 
 class CpuRuntime : public rt::Runtime {
   nxs_int numCores;
+  // Team shared memory, one arena per worker; outlives the workers
+  CpuScratch scratch;
   ThreadPool threadpool;
   rt::Pool<rt::Buffer, 256> buffer_pool;
+  CpuBufferCache buffer_cache;
   rt::Pool<CpuCommand> command_pool;
   rt::Pool<CpuSchedule, 256> schedule_pool;
+  CpuLibraryCache library_cache;
+
+  // Live streams; work outside a stream waits for them (default stream).
+  // Shared so that a waiter keeps a stream alive across its release.
+  std::mutex stream_mutex;
+  std::vector<std::shared_ptr<CpuStream>> streams;
+
+  // Orders view creation against the release of the buffer it views, so a
+  // view never retains a buffer that is being freed
+  std::mutex view_mutex;
+
+  // Kernel handles whose library never imports _cpu_barrier. Keyed by
+  // handle rather than address: an unloaded library's addresses are reused
+  // by the next one, handles are not.
+  std::mutex kernel_mutex;
+  std::unordered_set<nxs_int> barrier_free_kernels;
+
+  // Bulk fills and copies below this run on the calling thread
+  static constexpr size_t kParallelBytes = size_t(1) << 20;
+
+  // Run fn(begin, end) over [0, size) in up to one stripe per worker, each
+  // at least `min_stripe` bytes and starting on a `align` boundary
+  template <typename F>
+  void forEachStripe(size_t size, size_t min_stripe, size_t align, F &&fn) {
+    size_t stripes =
+        std::max<size_t>(1, std::min(threadpool.size(), size / min_stripe));
+    threadpool.parallel_for(stripes, [&](size_t i) {
+      size_t begin = std::min(size, rt::roundUp(size * i / stripes, align));
+      size_t end = i + 1 == stripes
+                       ? size
+                       : std::min(size, rt::roundUp(size * (i + 1) / stripes,
+                                                    align));
+      if (begin < end) fn(begin, end);
+    });
+  }
+
+  // Write every page of a new buffer from the worker pool in page-aligned
+  // stripes, so the pages are spread over the nodes of the pinned workers
+  // rather than all placed on the caller's. Stripes go to whichever worker
+  // takes them; this does not match them to the workers of later kernels.
+  void firstTouch(rt::Buffer *buf, const void *src) {
+    char *dst = buf->data();
+    if (!dst) return;
+    size_t page = buf->getPageSize();
+    forEachStripe(buf->getSizeBytes(), page, page,
+                  [&](size_t begin, size_t end) {
+                    if (src)
+                      std::memcpy(dst + begin, (const char *)src + begin,
+                                  end - begin);
+                    else
+                      std::memset(dst + begin, 0, end - begin);
+                  });
+  }
 
   nxs_int initNumCores() const {
     cpuinfo_initialize();
@@ -28,7 +97,11 @@ class CpuRuntime : public rt::Runtime {
   }
 
  public:
-  CpuRuntime() : rt::Runtime(), numCores(initNumCores()), threadpool(numCores) {
+  CpuRuntime()
+      : rt::Runtime(),
+        numCores(initNumCores()),
+        scratch(numCores),
+        threadpool(numCores) {
     addObject((nxs_long)0);  // device 0
   }
   ~CpuRuntime() = default;
@@ -39,6 +112,106 @@ class CpuRuntime : public rt::Runtime {
 
   ThreadPool *getThreadPool() { return &threadpool; }
 
+  CpuLibraryCache *getLibraryCache() { return &library_cache; }
+
+  CpuBufferCache *getBufferCache() { return &buffer_cache; }
+
+  CpuScratch *getScratch() { return &scratch; }
+
+  // Fill `size` bytes with the pattern continued from byte `phase`, in
+  // page-aligned stripes across the worker pool for large ranges
+  void fill(char *dst, size_t size, const void *value, size_t value_size,
+            size_t phase, bool streaming) {
+    forEachStripe(size, kParallelBytes, rt::getSystemPageSize(),
+                  [&](size_t begin, size_t end) {
+                    CpuMemOps::fill(dst + begin, end - begin, value,
+                                    value_size, phase + begin, streaming);
+                  });
+  }
+
+  // Copy `size` bytes between non-overlapping ranges, split like fill()
+  void copy(char *dst, const char *src, size_t size, bool streaming) {
+    forEachStripe(size, kParallelBytes, rt::getSystemPageSize(),
+                  [&](size_t begin, size_t end) {
+                    CpuMemOps::copy(dst + begin, src + begin, end - begin,
+                                    streaming);
+                  });
+  }
+
+  /// @brief Copy bytes [offset, offset + size) of the buffer's packed
+  /// contents to (NXS_BufferDeviceToHost) or from (NXS_BufferHostToDevice)
+  /// `host_ptr`; strided views are gathered or scattered run by run.
+  nxs_status copyBuffer(rt::Buffer *buf, void *host_ptr, nxs_uint direction,
+                        size_t offset, size_t size) {
+    size_t total = buf->getSizeBytes();
+    if (!host_ptr) return NXS_InvalidHostPtr;
+    if (offset > total || size > total - offset) return NXS_InvalidBuffer;
+    bool to_device = direction == NXS_BufferHostToDevice;
+    bool streaming = size >= CpuMemOps::getStreamingThreshold();
+    char *host = static_cast<char *>(host_ptr);
+    auto copy_run = [&](char *run, size_t bytes, size_t packed) {
+      // clip the run to the requested range
+      size_t begin = std::max(packed, offset);
+      size_t end = std::min(packed + bytes, offset + size);
+      if (begin >= end) return;
+      char *data = run + (begin - packed);
+      char *other = host + (begin - offset);
+      // a zero-copy buffer copied onto the memory it aliases is done
+      if (data == other) return;
+      if (to_device)
+        copy(data, other, end - begin, streaming);
+      else
+        copy(other, data, end - begin, streaming);
+    };
+    if (!buf->forEachRun(copy_run)) return NXS_InvalidBuffer;
+    return NXS_Success;
+  }
+
+  /// @brief Copy a region between raw ranges (see nxs_buffer_region); rows
+  /// are split across the worker pool when the region is large.
+  void copyRegion(char *dst, const char *src, const nxs_buffer_region &region) {
+    size_t row = region.extent[0];
+    size_t rows = 1;
+    for (nxs_uint d = 1; d < region.rank; ++d) rows *= region.extent[d];
+    bool streaming = row * rows >= CpuMemOps::getStreamingThreshold();
+    if (rows == 1) {
+      // a single range may move within one buffer
+      if (dst < src + row && src < dst + row)
+        std::memmove(dst, src, row);
+      else
+        copy(dst, src, row, streaming);
+      return;
+    }
+    size_t min_rows = std::max<size_t>(1, kParallelBytes / std::max<size_t>(row, 1));
+    forEachStripe(rows, min_rows, 1, [&](size_t begin, size_t end) {
+      for (size_t r = begin; r < end; ++r) {
+        size_t src_pos = 0, dst_pos = 0, rest = r;
+        for (nxs_uint d = 1; d < region.rank; ++d) {
+          size_t index = rest % region.extent[d];
+          rest /= region.extent[d];
+          src_pos += index * region.src_stride[d];
+          dst_pos += index * region.dst_stride[d];
+        }
+        CpuMemOps::copy(dst + dst_pos, src + src_pos, row, streaming);
+      }
+    });
+  }
+
+  void setBarrierFree(nxs_int kernel_id) {
+    std::lock_guard<std::mutex> lock(kernel_mutex);
+    barrier_free_kernels.insert(kernel_id);
+  }
+  bool isBarrierFree(nxs_int kernel_id) {
+    std::lock_guard<std::mutex> lock(kernel_mutex);
+    return barrier_free_kernels.count(kernel_id) != 0;
+  }
+  nxs_status releaseKernel(nxs_int kernel_id) {
+    std::lock_guard<std::mutex> lock(kernel_mutex);
+    if (!dropObject(kernel_id)) return NXS_InvalidKernel;
+    barrier_free_kernels.erase(kernel_id);
+    return NXS_Success;
+  }
+
   template <typename T>
   T getPtr(nxs_int id) {
     return static_cast<T>(get(id));
@@ -46,18 +219,142 @@ class CpuRuntime : public rt::Runtime {
 
   rt::Buffer *getBuffer(nxs_buffer_layout shape, void *data_ptr = nullptr,
                         nxs_uint settings = 0) {
-    return buffer_pool.get_new(shape, data_ptr, settings | NXS_BufferSettings_Maintain);
+    // Zero-copy buffers alias the caller's memory, everything else gets a
+    // runtime-owned copy
+    if (!data_ptr || !(settings & NXS_BufferSettings_ZeroCopy))
+      settings |= NXS_BufferSettings_Maintain;
+    if (!(settings & NXS_BufferSettings_Maintain))
+      return buffer_pool.get_new(shape, data_ptr, settings);
+
+    auto memory =
+        buffer_cache.allocate(rt::Buffer::getSizeBytes(shape), settings);
+    if (!memory.ptr) return nullptr;
+    bool first_touch = settings & NXS_BufferSettings_FirstTouch;
+    auto *buf = buffer_pool.get_new(shape, memory,
+                                    first_touch ? nullptr : data_ptr, settings);
+    if (!buf) {
+      buffer_cache.release(memory, rt::Buffer::getSizeBytes(shape), settings);
+      return nullptr;
+    }
+    if (first_touch) firstTouch(buf, data_ptr);
+    return buf;
+  }
+  rt::Buffer *getSubBuffer(nxs_int parent_id, size_t offset,
+                           const nxs_buffer_layout &shape,
+                           nxs_uint settings = 0) {
+    std::lock_guard<std::mutex> lock(view_mutex);
+    auto parent = get<rt::Buffer>(parent_id);
+    if (!parent || shape.rank > NXS_MAX_DIMS) return nullptr;
+    size_t extent = rt::Buffer::getExtentBytes(shape);
+    size_t parent_extent = parent->getExtentBytes();
+    if (offset > parent_extent || extent > parent_extent - offset)
+      return nullptr;
+    return buffer_pool.get_new(parent, offset, shape, settings);
   }
   nxs_status releaseBuffer(nxs_int buffer_id) {
     auto buf = get<rt::Buffer>(buffer_id);
     if (!buf) return NXS_InvalidBuffer;
-    buffer_pool.release(buf);
+    // queued stream work may still use the memory, and the cache below
+    // would hand it to the next buffer
+    waitStreams(buf);
+    std::lock_guard<std::mutex> lock(view_mutex);
+    // dropping the handle first makes a racing double release fail here
     if (!dropObject(buffer_id)) return NXS_InvalidBuffer;
+    // the memory goes when the last view of it does
+    while (buf && buf->drop()) {
+      auto *parent = buf->getParent();
+      if (buf->isMaintained()) {
+        size_t size = buf->getSizeBytes();
+        nxs_uint settings = buf->getSettings();
+        buffer_cache.release(buf->detachMemory(), size, settings);
+      }
+      buf->release();
+      buffer_pool.release(buf);
+      buf = parent;
+    }
+    return NXS_Success;
+  }
+
+  nxs_int getEvent(nxs_event_type type, nxs_uint settings = 0) {
+    return addObject(new CpuEvent(type, settings), true);
+  }
+  nxs_status releaseEvent(nxs_int event_id) {
+    if (!get<CpuEvent>(event_id)) return NXS_InvalidEvent;
+    if (!dropObject(event_id, rt::delete_fn<CpuEvent>))
+      return NXS_InvalidEvent;
     return NXS_Success;
   }
 
+  nxs_int getStream(nxs_uint settings = 0) {
+    auto stream = std::make_shared<CpuStream>(&threadpool, settings);
+    {
+      std::lock_guard<std::mutex> lock(stream_mutex);
+      streams.push_back(stream);
+    }
+    return addObject(stream.get());
+  }
+  nxs_status releaseStream(nxs_int stream_id) {
+    auto stream = get<CpuStream>(stream_id);
+    if (!stream) return NXS_InvalidStream;
+    if (!dropObject(stream_id)) return NXS_InvalidStream;
+    // ~CpuStream drains whatever is still queued once the last waiter
+    // lets go of it
+    std::shared_ptr<CpuStream> owned;
+    {
+      std::lock_guard<std::mutex> lock(stream_mutex);
+      auto it = std::find_if(streams.begin(), streams.end(),
+                             [&](auto &s) { return s.get() == stream; });
+      owned = std::move(*it);
+      streams.erase(it);
+    }
+    return NXS_Success;
+  }
+
+  /// @brief Wait for queued stream work of the streams for which
+  /// pred(stream) holds; waits outside stream_mutex.
+  template <typename Pred>
+  void waitStreamsIf(Pred &&pred) {
+    std::vector<std::shared_ptr<CpuStream>> pending;
+    {
+      std::lock_guard<std::mutex> lock(stream_mutex);
+      for (auto &stream : streams)
+        if (pred(*stream)) pending.push_back(stream);
+    }
+    for (auto &stream : pending) stream->wait();
+  }
+
+  /// @brief Wait for all queued stream work, like the legacy default
+  /// stream does before running anything itself.
+  void waitStreams() {
+    waitStreamsIf([](CpuStream &) { return true; });
+  }
+
+  /// @brief Wait for the streams that have a run queued of a schedule
+  /// using bytes [begin, end).
+  void waitStreams(const char *begin, const char *end) {
+    if (begin == end) return;
+    waitStreamsIf([&](CpuStream &stream) {
+      return stream.uses(
+          [&](CpuSchedule *sched) { return sched->touches(begin, end); });
+    });
+  }
+
+  /// @brief Wait for the streams that use the allocation behind `buf`
+  /// (all views of it, conservatively).
+  void waitStreams(rt::Buffer *buf) {
+    while (buf->getParent()) buf = buf->getParent();
+    waitStreams(buf->data(), buf->data() + buf->getExtentBytes());
+  }
+
+  /// @brief Wait for the streams that have a run of `schedule` queued.
+  void waitStreams(CpuSchedule *schedule) {
+    waitStreamsIf([&](CpuStream &stream) {
+      return stream.uses([&](CpuSchedule *sched) { return sched == schedule; });
+    });
+  }
+
   nxs_int getSchedule(nxs_int device_id, nxs_uint settings = 0) {
-    auto schedule = schedule_pool.get_new(device_id, settings);
+    auto schedule = schedule_pool.get_new(this, device_id, settings);
     if (!schedule) return NXS_InvalidSchedule;
     return addObject(schedule);
   }
@@ -66,29 +363,39 @@ class CpuRuntime : public rt::Runtime {
     return command_pool.get_new(this, kernel, settings);
   }
 
-  CpuCommand *getCommand(nxs_int event, nxs_command_type type,
+  CpuCommand *getCommand(CpuEvent *event, nxs_command_type type,
                          nxs_int event_value = 0, nxs_uint settings = 0) {
     return command_pool.get_new(this, event, type, event_value, settings);
   }
 
+  /// @brief Return a command that never made it into a schedule.
+  void discardCommand(CpuCommand *command) { command_pool.release(command); }
+
+  nxs_int addCommand(CpuSchedule *schedule, CpuCommand *command) {
+    nxs_int command_id = addObject(command);
+    schedule->addCommand(command, command_id);
+    return command_id;
+  }
+
   nxs_status releaseCommand(nxs_int command_id) {
     auto cmd = get<CpuCommand>(command_id);
     if (!cmd) return NXS_InvalidCommand;
     // cmd->release();
-    command_pool.release(cmd);
     if (!dropObject(command_id)) return NXS_InvalidCommand;
+    command_pool.release(cmd);
     return NXS_Success;
   }
 
   nxs_status releaseSchedule(nxs_int schedule_id) {
     auto sched = get<CpuSchedule>(schedule_id);
     if (!sched) return NXS_InvalidSchedule;
-    for (auto cmd : sched->getCommands()) {
-      // releaseCommand(cmd->getId());
-    }
+    // a queued run may still use the schedule and its commands, which the
+    // pools below hand to the next ones created
+    waitStreams(sched);
+    if (!dropObject(schedule_id)) return NXS_InvalidSchedule;
+    for (auto command_id : sched->getCommandIds()) releaseCommand(command_id);
     sched->release();
     schedule_pool.release(sched);
-    if (!dropObject(schedule_id)) return NXS_InvalidSchedule;
     return NXS_Success;
   }
 };
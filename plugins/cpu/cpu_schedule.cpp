@@ -1,8 +1,10 @@
-
 #include "cpu_schedule.h"
 
 #include "cpu_runtime.h"
 
+#include <algorithm>
+#include <numeric>
+
 #define NXSAPI_LOG_MODULE "cpu_runtime"
 
 float CpuSchedule::getTime() const {
@@ -11,16 +13,240 @@ float CpuSchedule::getTime() const {
       .count();
 }
 
+bool CpuSchedule::planIsCurrent() const {
+  auto &commands = getCommands();
+  if (!plan || plan->revisions.size() != commands.size()) return false;
+  for (size_t i = 0; i < commands.size(); ++i)
+    if (commands[i]->getRevision() != plan->revisions[i]) return false;
+  return true;
+}
+
+CpuSchedule::Snapshot CpuSchedule::buildPlan() const {
+  auto &commands = getCommands();
+  const size_t count = commands.size();
+
+  // step[i] = 1 + the latest step of any command i depends on
+  std::vector<uint32_t> step(count, 0);
+  uint32_t steps = 0;
+  for (size_t i = 0; i < count; ++i) {
+    bool barrier = commands[i]->getType() != NXS_CommandType_Dispatch;
+    for (size_t j = 0; j < i; ++j) {
+      if (step[j] < step[i]) continue;
+      if (barrier || commands[j]->getType() != NXS_CommandType_Dispatch ||
+          commands[i]->conflictsWith(*commands[j]))
+        step[i] = step[j] + 1;
+    }
+    steps = std::max(steps, step[i] + 1);
+  }
+
+  std::vector<uint32_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](uint32_t a, uint32_t b) { return step[a] < step[b]; });
+
+  auto next = std::make_shared<CpuSchedulePlan>();
+  next->order = order;
+  next->step_begin.assign(1, 0);
+  for (auto idx : order) {
+    while (next->step_begin.size() <= step[idx])
+      next->step_begin.push_back(next->commands.size());
+    next->commands.push_back(commands[idx]);
+  }
+  next->step_begin.push_back(next->commands.size());
+
+  next->revisions.resize(count);
+  for (size_t i = 0; i < count; ++i)
+    next->revisions[i] = commands[i]->getRevision();
+
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "buildPlan ", count, " commands in ", steps,
+             " steps");
+  return next;
+}
+
+nxs_status CpuSchedule::capture(const CpuSchedulePlan &from,
+                                Snapshot &result) const {
+  auto next = std::make_shared<CpuSchedulePlan>(from);
+  next->captured.clear();
+  next->captured.reserve(next->commands.size());
+  for (auto *cmd : next->commands) {
+    CpuSchedulePlan::CapturedOp op{cmd->getType(),     cmd->getEvent(),
+                                   cmd->getEventValue(), cmd->getRevision(),
+                                   cmd->getLayoutRevision(), {}};
+    if (op.type == NXS_CommandType_Dispatch) {
+      auto status = cmd->prepareLaunch(op.launch);
+      if (!nxs_success(status)) return status;
+    }
+    next->captured.push_back(op);
+  }
+  next->is_captured = true;
+  NXSAPI_LOG(nexus::NXS_LOG_NOTE, "capture ", next->captured.size(),
+             " commands");
+  result = std::move(next);
+  return NXS_Success;
+}
+
+bool CpuSchedule::stepsKeepOrder(const CpuSchedulePlan &plan, uint32_t pos,
+                                 size_t step) {
+  // Every dispatch the command at plan[pos] overlaps must run in an
+  // earlier step if it was submitted before, and in a later one otherwise
+  auto &commands = plan.commands;
+  for (size_t other = 0; other < plan.getStepCount(); ++other) {
+    for (uint32_t j = plan.step_begin[other]; j < plan.step_begin[other + 1];
+         ++j) {
+      if (j == pos || commands[j]->getType() != NXS_CommandType_Dispatch ||
+          !commands[pos]->conflictsWith(*commands[j]))
+        continue;
+      bool before = plan.order[j] < plan.order[pos];
+      if (before ? other >= step : other <= step) return false;
+    }
+  }
+  return true;
+}
+
+// With plan_mutex held: publish a patched copy of the capture when some
+// of its commands were rebound since.
+nxs_status CpuSchedule::updateCapture() {
+  std::shared_ptr<CpuSchedulePlan> next;
+  for (size_t step = 0; step < plan->getStepCount(); ++step) {
+    const uint32_t begin = plan->step_begin[step];
+    const uint32_t end = plan->step_begin[step + 1];
+    for (uint32_t i = begin; i < end; ++i) {
+      auto *cmd = plan->commands[i];
+      if (plan->captured[i].type != NXS_CommandType_Dispatch ||
+          cmd->getRevision() == plan->captured[i].revision)
+        continue;
+      if (!stepsKeepOrder(*plan, i, step)) {
+        NXSAPI_LOG(nexus::NXS_LOG_NOTE, "updateCapture rebuilds the plan");
+        return capture(*buildPlan(), plan);
+      }
+      if (!next) next = std::make_shared<CpuSchedulePlan>(*plan);
+      auto &op = next->captured[i];
+      if (cmd->getLayoutRevision() != op.layout_revision) {
+        auto status = cmd->prepareLaunch(op.launch);
+        if (!nxs_success(status)) return status;
+        op.layout_revision = cmd->getLayoutRevision();
+      } else {
+        cmd->patchLaunch(op.launch);
+      }
+      op.revision = cmd->getRevision();
+    }
+  }
+  if (next) plan = std::move(next);
+  return NXS_Success;
+}
+
+nxs_status CpuSchedule::acquirePlan(nxs_uint settings, Snapshot &snapshot) {
+  std::lock_guard<std::mutex> lock(plan_mutex);
+  if (plan && plan->is_captured) {
+    auto status = updateCapture();
+    if (!nxs_success(status)) return status;
+  } else {
+    if (!planIsCurrent()) plan = buildPlan();
+    if (rt && (settings & NXS_ExecutionSettings_Capture)) {
+      auto status = capture(*plan, plan);
+      if (!nxs_success(status)) return status;
+    }
+  }
+  snapshot = plan;
+  return NXS_Success;
+}
+
+bool CpuSchedule::touches(const char *begin, const char *end) {
+  std::lock_guard<std::mutex> lock(plan_mutex);
+  for (auto *cmd : getCommands())
+    if (cmd->touches(begin, end)) return true;
+  return false;
+}
+
+size_t CpuSchedule::getStepCount() {
+  std::lock_guard<std::mutex> lock(plan_mutex);
+  return plan ? plan->getStepCount() : 0;
+}
+
+void CpuSchedule::replayStep(const CpuSchedulePlan &plan, size_t step) {
+  auto replay = [this](const CpuSchedulePlan::CapturedOp &op) {
+    switch (op.type) {
+      case NXS_CommandType_Dispatch:
+        CpuCommand::execute(rt->getThreadPool(), op.launch);
+        break;
+      case NXS_CommandType_Signal:
+        op.event->signal(op.event_value);
+        break;
+      case NXS_CommandType_Wait:
+        op.event->wait(op.event_value);
+        break;
+    }
+  };
+  const uint32_t begin = plan.step_begin[step];
+  const uint32_t width = plan.step_begin[step + 1] - begin;
+  if (width == 1) {
+    replay(plan.captured[begin]);
+    return;
+  }
+  rt->getThreadPool()->parallel_for(
+      width, [&](size_t i) { replay(plan.captured[begin + i]); });
+}
+
+nxs_status CpuSchedule::runStep(const CpuSchedulePlan &plan, size_t step,
+                                nxs_int stream) {
+  const uint32_t begin = plan.step_begin[step];
+  const uint32_t width = plan.step_begin[step + 1] - begin;
+  if (width == 1 || !rt) {
+    for (uint32_t i = 0; i < width; ++i) {
+      auto status = plan.commands[begin + i]->runCommand(stream);
+      if (!nxs_success(status)) return status;
+    }
+    return NXS_Success;
+  }
+
+  // Independent dispatches; each one fans out its teams on the same pool
+  std::atomic<int> failed{NXS_Success};
+  rt->getThreadPool()->parallel_for(width, [&](size_t i) {
+    auto status = plan.commands[begin + i]->runCommand(stream);
+    if (!nxs_success(status)) {
+      int expected = NXS_Success;
+      failed.compare_exchange_strong(expected, status);
+    }
+  });
+  return (nxs_status)failed.load();
+}
+
 nxs_status CpuSchedule::run(nxs_int stream, nxs_uint run_settings) {
+  size_t pos = 0;
+  Snapshot snapshot;
+  return run(stream, run_settings, pos, snapshot, nullptr);
+}
+
+nxs_status CpuSchedule::run(nxs_int stream, nxs_uint run_settings,
+                            size_t &pos, Snapshot &snapshot,
+                            CpuCommand **blocked_on) {
   nxs_uint settings = getSettings() | run_settings;
 
-  if (settings & NXS_ExecutionSettings_Timing) {
-    start_time = std::chrono::steady_clock::now();
+  if (!snapshot) {
+    auto status = acquirePlan(settings, snapshot);
+    if (!nxs_success(status)) return status;
+    if (settings & NXS_ExecutionSettings_Timing)
+      start_time = std::chrono::steady_clock::now();
   }
 
-  for (auto cmd : getCommands()) {
-    NXSAPI_LOG(nexus::NXS_LOG_NOTE, "runCommand ", " - ", cmd->getType());
-    auto status = cmd->runCommand(stream);
+  const CpuSchedulePlan &current = *snapshot;
+  const size_t steps = current.getStepCount();
+  for (; pos < steps; ++pos) {
+    auto *first = current.commands[current.step_begin[pos]];
+    // Wait commands are alone in their step
+    if (blocked_on && first->getType() == NXS_CommandType_Wait &&
+        first->getEvent() &&
+        !first->getEvent()->isReached(first->getEventValue())) {
+      *blocked_on = first;
+      ++pos;
+      return NXS_Success;
+    }
+    if (current.is_captured) {
+      replayStep(current, pos);
+      continue;
+    }
+    NXSAPI_LOG(nexus::NXS_LOG_NOTE, "runStep ", pos);
+    auto status = runStep(current, pos, stream);
     if (!nxs_success(status)) return status;
   }
 
@@ -30,7 +256,20 @@ nxs_status CpuSchedule::run(nxs_int stream, nxs_uint run_settings) {
   return NXS_Success;
 }
 
+bool CpuSchedule::removeCommand(CpuCommand *command, nxs_int command_id) {
+  std::lock_guard<std::mutex> lock(plan_mutex);
+  auto it = std::find(command_ids.begin(), command_ids.end(), command_id);
+  if (it == command_ids.end() || !Schedule::removeCommand(command))
+    return false;
+  command_ids.erase(it);
+  plan.reset();
+  return true;
+}
+
 nxs_status CpuSchedule::release() {
   nxs_status status = Schedule::release();
+  std::lock_guard<std::mutex> lock(plan_mutex);
+  plan.reset();
+  command_ids.clear();
   return status;
 }
@@ -5,21 +5,132 @@
 #include <rt_schedule.h>
 
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
 
+/************************************************************************
+ * @struct CpuSchedulePlan
+ * @brief Immutable snapshot of a schedule's execution plan.
+ *
+ * Commands ordered by step; step i is
+ * commands[step_begin[i]] .. commands[step_begin[i + 1]]. A run holds the
+ * snapshot it started with until it finishes, including across a park on
+ * a wait command, so rebuilding or recapturing the plan never touches
+ * vectors another run is iterating.
+ ***********************************************************************/
+struct CpuSchedulePlan {
+  std::vector<CpuCommand *> commands;
+  std::vector<uint32_t> step_begin;
+  // Revision of each schedule command (in submission order) at build time
+  std::vector<uint32_t> revisions;
+  // Submission index of each plan entry
+  std::vector<uint32_t> order;
+
+  // Frozen copy of the plan, parallel to `commands`; revisions are those
+  // of the command when its launch was last brought up to date
+  struct CapturedOp {
+    nxs_command_type type;
+    CpuEvent *event;
+    nxs_int event_value;
+    uint32_t revision;
+    uint32_t layout_revision;
+    CpuLaunch launch;
+  };
+  std::vector<CapturedOp> captured;
+  bool is_captured = false;
+
+  size_t getStepCount() const {
+    return commands.empty() ? 0 : step_begin.size() - 1;
+  }
+};
+
+/************************************************************************
+ * @class CpuSchedule
+ * @brief Schedule that runs independent commands concurrently.
+ *
+ * On first run the commands are turned into a dependency graph: two
+ * dispatches depend on each other when they touch overlapping buffer
+ * bytes and one of them writes, and signal/wait commands order everything
+ * before them against everything after. The graph is flattened into
+ * steps (topological levels); the commands of a step run concurrently on
+ * the thread pool. The plan is cached and only rebuilt when commands are
+ * added or their arguments change.
+ *
+ * A run with NXS_ExecutionSettings_Capture freezes the plan into resolved
+ * launches (kernel, argument frame, partitioning) per step, like a CUDA
+ * graph exec. Later runs replay them without validation, allocation or
+ * logging. Commands whose arguments were rebound since are patched into
+ * their launch before the replay (re-resolved if they were finalized
+ * again); only a rebinding that leaves a command overlapping another one
+ * it is not ordered after rebuilds the plan. Commands added after the
+ * capture are ignored until then or until release.
+ *
+ * Plans are immutable snapshots: building, capturing or patching one
+ * publishes a new plan, so a run on another stream keeps the one it
+ * started with.
+ ***********************************************************************/
 class CpuSchedule : public nxs::rt::Schedule<CpuCommand, nxs_int, nxs_int> {
+  CpuRuntime *rt;
   std::chrono::steady_clock::time_point start_time;
   std::chrono::steady_clock::time_point end_time;
 
+  using Snapshot = std::shared_ptr<const CpuSchedulePlan>;
+
+  // Current plan; replaced, never modified, under plan_mutex
+  std::mutex plan_mutex;
+  Snapshot plan;
+
+  // Runtime handles of the commands, released with the schedule
+  std::vector<nxs_int> command_ids;
+
+  Snapshot buildPlan() const;
+  nxs_status capture(const CpuSchedulePlan &from, Snapshot &result) const;
+  nxs_status updateCapture();
+  nxs_status acquirePlan(nxs_uint settings, Snapshot &snapshot);
+  static bool stepsKeepOrder(const CpuSchedulePlan &plan, uint32_t pos,
+                             size_t step);
+  void replayStep(const CpuSchedulePlan &plan, size_t step);
+  bool planIsCurrent() const;
+  nxs_status runStep(const CpuSchedulePlan &plan, size_t step,
+                     nxs_int stream);
+
  public:
-  CpuSchedule(nxs_int dev_id = -1, nxs_uint settings = 0)
-      : Schedule(dev_id, settings) {}
+  CpuSchedule(CpuRuntime *rt = nullptr, nxs_int dev_id = -1,
+              nxs_uint settings = 0)
+      : Schedule(dev_id, settings), rt(rt) {}
   virtual ~CpuSchedule() = default;
 
   float getTime() const;
 
+  void addCommand(CpuCommand *command, nxs_int command_id) {
+    Schedule::addCommand(command);
+    command_ids.push_back(command_id);
+  }
+  /// @brief Take a command out of the schedule; drops the plan and any
+  /// capture, which may hold it.
+  bool removeCommand(CpuCommand *command, nxs_int command_id);
+  const std::vector<nxs_int> &getCommandIds() const { return command_ids; }
+
+  /// @brief True if a command of the schedule has a buffer argument that
+  /// overlaps bytes [begin, end).
+  bool touches(const char *begin, const char *end);
+
+  /// @brief Number of steps in the cached plan (0 before the first run).
+  size_t getStepCount();
+
   nxs_status run(nxs_int stream, nxs_uint run_settings) override;
 
+  /// @brief Run the plan snapshot from step pos; an empty snapshot is
+  /// replaced by the current plan. With blocked_on set, stops at a wait
+  /// command whose event is not reached yet: *blocked_on is that command
+  /// and pos the step after it; resume with the same snapshot. Otherwise
+  /// such waits block.
+  nxs_status run(nxs_int stream, nxs_uint run_settings, size_t &pos,
+                 std::shared_ptr<const CpuSchedulePlan> &snapshot,
+                 CpuCommand **blocked_on);
+
   nxs_status release() override;
 };
 
-#endif  // RT_CPU_SCHEDULE_H
\ No newline at end of file
+#endif  // RT_CPU_SCHEDULE_H
@@ -0,0 +1,52 @@
+#include "cpu_scratch.h"
+
+#include <cstdlib>
+#include <cstring>
+
+CpuScratch::CpuScratch(size_t workers)
+    : workers(workers), arenas(new Arena[workers + 1]) {}
+
+CpuScratch::~CpuScratch() {
+  for (size_t i = 0; i <= workers; ++i) std::free(arenas[i].ptr);
+}
+
+CpuScratch::Slice::~Slice() {
+  if (!bytes) return;
+  scratch->used.fetch_sub(bytes, std::memory_order_relaxed);
+  if (arena)
+    arena->busy.store(false, std::memory_order_release);
+  else
+    std::free(ptr);
+}
+
+CpuScratch::Slice CpuScratch::borrow(size_t bytes, int worker) {
+  bytes = (bytes + 63) & ~size_t(63);
+  if (bytes == 0) return Slice(this, nullptr, nullptr, 0);
+
+  size_t now = used.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  size_t seen = peak.load(std::memory_order_relaxed);
+  while (now > seen &&
+         !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed))
+    ;
+
+  Arena &arena = arenas[worker >= 0 && size_t(worker) < workers
+                            ? size_t(worker)
+                            : workers];
+  if (arena.busy.exchange(true, std::memory_order_acquire)) {
+    // a nested borrow, or two outside threads at once: stay correct with
+    // a private allocation
+    return Slice(this, nullptr,
+                 static_cast<unsigned char *>(std::aligned_alloc(64, bytes)),
+                 bytes);
+  }
+  if (arena.capacity < bytes) {
+    std::free(arena.ptr);
+    reserved.fetch_sub(arena.capacity, std::memory_order_relaxed);
+    arena.ptr = static_cast<unsigned char *>(std::aligned_alloc(64, bytes));
+    // first touch from the owning worker places the pages locally
+    std::memset(arena.ptr, 0, bytes);
+    arena.capacity = bytes;
+    reserved.fetch_add(bytes, std::memory_order_relaxed);
+  }
+  return Slice(this, &arena, arena.ptr, bytes);
+}
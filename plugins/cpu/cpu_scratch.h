@@ -0,0 +1,73 @@
+#ifndef RT_CPU_SCRATCH_H
+#define RT_CPU_SCRATCH_H
+
+#include <nexus-api.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/************************************************************************
+ * @class CpuScratch
+ * @brief Reusable per-worker scratch memory for team shared memory.
+ *
+ * Owned by a CpuRuntime, with one 64B aligned arena per pool worker plus
+ * one shared by threads outside the pool. An arena grows to the largest
+ * request seen (high-water mark) and is never returned to the allocator,
+ * so steady-state launches do not allocate. Worker arenas are allocated
+ * and first touched by the worker that uses them, which keeps them on
+ * the local NUMA node of the pinned workers.
+ ***********************************************************************/
+class CpuScratch {
+  struct alignas(64) Arena {
+    unsigned char *ptr = nullptr;
+    size_t capacity = 0;
+    std::atomic<bool> busy{false};
+  };
+
+  size_t workers;
+  std::unique_ptr<Arena[]> arenas;  // workers + 1, the last for outsiders
+  std::atomic<size_t> used{0};
+  std::atomic<size_t> peak{0};
+  std::atomic<size_t> reserved{0};
+
+ public:
+  /// @brief Scratch slice borrowed for the lifetime of one team.
+  class Slice {
+    CpuScratch *scratch;
+    Arena *arena;  // null when the slice owns its memory
+    unsigned char *ptr;
+    size_t bytes;
+
+   public:
+    Slice(CpuScratch *scratch, Arena *arena, unsigned char *ptr, size_t bytes)
+        : scratch(scratch), arena(arena), ptr(ptr), bytes(bytes) {}
+    Slice(const Slice &) = delete;
+    Slice &operator=(const Slice &) = delete;
+    ~Slice();
+
+    unsigned char *data() const { return ptr; }
+    size_t size() const { return bytes; }
+  };
+
+  explicit CpuScratch(size_t workers);
+  ~CpuScratch();
+
+  CpuScratch(const CpuScratch &) = delete;
+  CpuScratch &operator=(const CpuScratch &) = delete;
+
+  /// @brief Borrow at least `bytes` of scratch for pool worker `worker`
+  /// (negative for a thread outside the pool).
+  Slice borrow(size_t bytes, int worker);
+
+  /// @brief Bytes currently borrowed by running teams.
+  size_t getUsed() const { return used.load(std::memory_order_relaxed); }
+  /// @brief High-water mark of borrowed bytes.
+  size_t getPeak() const { return peak.load(std::memory_order_relaxed); }
+  /// @brief Bytes held by all arenas.
+  size_t getReserved() const {
+    return reserved.load(std::memory_order_relaxed);
+  }
+};
+
+#endif  // RT_CPU_SCRATCH_H
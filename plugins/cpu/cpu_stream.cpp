@@ -0,0 +1,112 @@
+#include <cpu_runtime.h>
+#include <cpu_stream.h>
+#include <nexus/log.h>
+
+CpuStream::CpuStream(ThreadPool *pool, nxs_uint settings)
+    : pool(pool), settings(settings) {
+  drain_job.invoke = [](const void *ctx, size_t) {
+    static_cast<CpuStream *>(const_cast<void *>(ctx))->drain();
+  };
+  drain_job.ctx = this;
+}
+
+CpuStream::~CpuStream() { synchronize(); }
+
+void CpuStream::drain() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (parked || !queue.empty()) {
+    if (!parked) {
+      current = queue.front();
+      queue.pop_front();
+    }
+    parked = false;
+    lock.unlock();
+
+    Entry &entry = current;
+    CpuCommand *cmd = nullptr;
+    auto status = entry.schedule->run(entry.stream_id, entry.settings,
+                                      entry.pos, entry.plan, &cmd);
+    if (nxs_success(status) && cmd) {
+      // Stopped at a wait command: park, or carry on if it got signaled
+      // in the meantime. The wait is satisfied once we are resumed.
+      parked = true;
+      if (cmd->getEvent()->park(cmd->getEventValue(), this)) return;
+      lock.lock();
+      continue;
+    }
+
+    lock.lock();
+    if (!nxs_success(status)) {
+      NXSAPI_LOG(nexus::NXS_LOG_ERROR, "stream run failed: ", status);
+      if (!entry.result && nxs_success(error)) error = status;
+    }
+    if (entry.result) *entry.result = status;
+    entry.plan.reset();
+    completed = entry.ticket;
+    done.notify_all();
+  }
+  busy = false;
+  done.notify_all();
+  // No member may be touched once the lock is dropped: a waiter in
+  // ~CpuStream can free the stream right away.
+}
+
+nxs_status CpuStream::enqueue(CpuSchedule *schedule, nxs_int stream_id,
+                              nxs_uint run_settings) {
+  const bool blocking = !(run_settings & NXS_ExecutionSettings_NonBlocking);
+  std::unique_lock<std::mutex> lock(mutex);
+
+  if (blocking && !busy && queue.empty()) {
+    // Fast path: nothing ahead of us, run on the calling thread. Keeping
+    // `busy` set orders concurrent submissions behind this run.
+    busy = true;
+    current.schedule = schedule;
+    lock.unlock();
+    auto status = schedule->run(stream_id, run_settings);
+    lock.lock();
+    if (queue.empty()) {
+      busy = false;
+      done.notify_all();
+    } else {
+      lock.unlock();
+      pool->submit(&drain_job);
+    }
+    return status;
+  }
+
+  nxs_status status = NXS_Success;
+  uint64_t ticket = ++submitted;
+  queue.push_back({schedule, stream_id, run_settings, ticket,
+                   blocking ? &status : nullptr, 0, nullptr});
+  if (!busy) {
+    busy = true;
+    lock.unlock();
+    pool->submit(&drain_job);
+    if (!blocking) return NXS_Success;
+    lock.lock();
+  }
+  if (!blocking) return NXS_Success;
+
+  done.wait(lock, [&] { return completed >= ticket; });
+  return status;
+}
+
+void CpuStream::resume() { pool->submit(&drain_job); }
+
+void CpuStream::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [&] { return !busy && queue.empty(); });
+}
+
+nxs_status CpuStream::synchronize() {
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [&] { return !busy && queue.empty(); });
+  nxs_status status = error;
+  error = NXS_Success;
+  return status;
+}
+
+size_t CpuStream::getPendingCount() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return queue.size() + (busy ? 1 : 0);
+}
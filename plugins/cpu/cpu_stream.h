@@ -0,0 +1,100 @@
+#ifndef RT_CPU_STREAM_H
+#define RT_CPU_STREAM_H
+
+#include <nexus-api.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "threadpool.h"
+
+class CpuSchedule;
+struct CpuSchedulePlan;
+
+/************************************************************************
+ * @class CpuStream
+ * @brief In-order submission queue drained on the runtime thread pool.
+ *
+ * Schedules enqueued on a stream run one after another in submission
+ * order; different streams drain concurrently on the pool workers. A
+ * blocking run on an idle stream executes inline on the caller, so the
+ * synchronous path costs no hand-off. Errors of non-blocking runs are
+ * kept and reported by the next synchronize(). A wait command on an
+ * unsignaled event parks the stream on the event rather than blocking a
+ * pool worker; the signal resumes the drain.
+ ***********************************************************************/
+class CpuStream {
+  struct Entry {
+    CpuSchedule *schedule;
+    nxs_int stream_id;
+    nxs_uint settings;
+    uint64_t ticket;
+    nxs_status *result;  // set for blocking runs, owned by the waiter
+    size_t pos;          // next plan step to run
+    // plan the run started with, kept across a park
+    std::shared_ptr<const CpuSchedulePlan> plan;
+  };
+
+  ThreadPool *pool;
+  nxs_uint settings;
+  ThreadPool::Job drain_job;
+
+  // Entry being drained; only the draining job (or a blocking run on an
+  // idle stream) touches it, `schedule` only under the mutex. `parked` is
+  // set while it waits on an event and resume() restarts the drain.
+  Entry current{};
+  bool parked = false;
+
+  std::mutex mutex;
+  std::condition_variable done;
+  std::deque<Entry> queue;
+  bool busy = false;
+  uint64_t submitted = 0;
+  uint64_t completed = 0;
+  nxs_status error = NXS_Success;
+
+  void drain();
+
+ public:
+  CpuStream(ThreadPool *pool, nxs_uint settings = 0);
+  ~CpuStream();
+
+  CpuStream(const CpuStream &) = delete;
+  CpuStream &operator=(const CpuStream &) = delete;
+
+  nxs_uint getSettings() const { return settings; }
+
+  /// @brief Queue a schedule run. Returns immediately when run_settings
+  /// has NXS_ExecutionSettings_NonBlocking, otherwise once it completed.
+  nxs_status enqueue(CpuSchedule *schedule, nxs_int stream_id,
+                     nxs_uint run_settings);
+
+  /// @brief Continue draining after the event a wait command parked on
+  /// was signaled.
+  void resume();
+
+  /// @brief Wait until every queued run has completed.
+  void wait();
+
+  /// @brief wait() and report the first error of a non-blocking run since
+  /// the last call.
+  nxs_status synchronize();
+
+  size_t getPendingCount();
+
+  /// @brief True if the running or a queued entry is a run of a schedule
+  /// for which pred(schedule) holds.
+  template <typename Pred>
+  bool uses(Pred &&pred) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (busy && current.schedule && pred(current.schedule)) return true;
+    for (auto &entry : queue)
+      if (pred(entry.schedule)) return true;
+    return false;
+  }
+};
+
+#endif  // RT_CPU_STREAM_H
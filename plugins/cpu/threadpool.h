@@ -5,15 +5,13 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <functional>
-#include <future>
-#include <iostream>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <type_traits>
 #include <vector>
-// #include <immintrin.h>  // For AVX/SSE SIMD intrinsics
-#include <random>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -27,13 +25,154 @@
 #include <pthread.h>
 #endif
 
+/************************************************************************
+ * @class ThreadPool
+ * @brief Persistent work-stealing pool used to run kernel teams.
+ *
+ * Every worker owns a Chase-Lev deque of index ranges. A fork-join
+ * `parallel_for(count, fn)` publishes a single root range; whoever picks
+ * it up splits it in halves, keeps the lower half and pushes the upper
+ * half onto its own deque where idle workers steal it. The submitting
+ * thread helps until every index has run, so a launch needs no
+ * std::function, packaged_task or future allocations. Idle workers spin
+ * briefly before parking on a condition variable.
+ *
+ * `submit(job)` posts a detached job (e.g. a stream drain) that only
+ * workers pick up, and only from their top-level loop, so a thread helping
+ * with a launch never ends up running somebody else's queue.
+ ***********************************************************************/
 class ThreadPool {
+ public:
+  /// @brief Unit of work. For submit() the caller owns the storage and
+  /// must keep it alive until invoke has returned; pending is unused.
+  struct Job {
+    void (*invoke)(const void *, size_t);
+    const void *ctx;
+    std::atomic<size_t> pending;
+  };
+
  private:
+
+  struct Task {
+    Job *job;
+    size_t begin;
+    size_t end;
+  };
+
+  // Chase-Lev deque: the owner pushes/pops at the bottom, thieves steal
+  // from the top. Slot fields are atomics so a racing read is benign; a
+  // torn task is always discarded by the failed CAS on `top`.
+  class TaskDeque {
+    struct Slot {
+      std::atomic<Job *> job{nullptr};
+      std::atomic<size_t> begin{0};
+      std::atomic<size_t> end{0};
+    };
+    struct Ring {
+      int64_t mask;
+      std::unique_ptr<Slot[]> slots;
+      explicit Ring(int64_t capacity)
+          : mask(capacity - 1), slots(new Slot[capacity]) {}
+      int64_t capacity() const { return mask + 1; }
+      void put(int64_t i, const Task &t) {
+        Slot &s = slots[i & mask];
+        s.job.store(t.job, std::memory_order_relaxed);
+        s.begin.store(t.begin, std::memory_order_relaxed);
+        s.end.store(t.end, std::memory_order_relaxed);
+      }
+      Task get(int64_t i) const {
+        const Slot &s = slots[i & mask];
+        return {s.job.load(std::memory_order_relaxed),
+                s.begin.load(std::memory_order_relaxed),
+                s.end.load(std::memory_order_relaxed)};
+      }
+    };
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<Ring *> ring;
+    // old rings stay alive until the deque dies; thieves may still read them
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    Ring *grow(Ring *old, int64_t b, int64_t t) {
+      rings.emplace_back(new Ring(old->capacity() * 2));
+      Ring *r = rings.back().get();
+      for (int64_t i = t; i < b; ++i) r->put(i, old->get(i));
+      ring.store(r, std::memory_order_release);
+      return r;
+    }
+
+   public:
+    TaskDeque() {
+      rings.emplace_back(new Ring(64));
+      ring.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    void push(const Task &task) {
+      int64_t b = bottom.load(std::memory_order_relaxed);
+      int64_t t = top.load(std::memory_order_acquire);
+      Ring *r = ring.load(std::memory_order_relaxed);
+      if (b - t > r->capacity() - 1) r = grow(r, b, t);
+      r->put(b, task);
+      std::atomic_thread_fence(std::memory_order_release);
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    bool pop(Task &task) {
+      int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+      Ring *r = ring.load(std::memory_order_relaxed);
+      bottom.store(b, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      int64_t t = top.load(std::memory_order_relaxed);
+      if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+      }
+      task = r->get(b);
+      if (t == b) {
+        bool won = top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+      }
+      return true;
+    }
+
+    bool steal(Task &task) {
+      int64_t t = top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      int64_t b = bottom.load(std::memory_order_acquire);
+      if (t >= b) return false;
+      Ring *r = ring.load(std::memory_order_acquire);
+      task = r->get(t);
+      return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed);
+    }
+  };
+
+  // Number of empty polls before an idle worker parks.
+  static constexpr int kSpinCount = 1 << 10;
+
+  // Fixed before any worker starts; workers never read `workers` itself.
+  const size_t thread_count;
+  std::unique_ptr<TaskDeque[]> deques;
   std::vector<std::thread> workers;
-  std::queue<std::function<void()>> tasks;
-  std::mutex queue_mutex;
+  // Tasks pushed from threads outside the pool land here.
+  TaskDeque injector;
+  std::mutex injector_mutex;
+  // Detached jobs from submit(), guarded by injector_mutex
+  std::deque<Job *> posted;
+  std::atomic<size_t> posted_count{0};
+
+  std::mutex sleep_mutex;
   std::condition_variable condition;
-  std::atomic<bool> stop;
+  std::atomic<uint64_t> epoch{0};
+  std::atomic<int> sleepers{0};
+  std::atomic<bool> stop{false};
+
+  static inline thread_local ThreadPool *tl_pool = nullptr;
+  static inline thread_local int tl_index = -1;
+  static inline thread_local uint32_t tl_seed = 0x9e3779b9u;
 
   void set_thread_affinity(int core_id) {
 #ifdef _WIN32
@@ -84,9 +223,114 @@ class ThreadPool {
 #endif
   }
 
+  void push(const Task &task) {
+    if (tl_pool == this && tl_index >= 0) {
+      deques[tl_index].push(task);
+    } else {
+      std::lock_guard<std::mutex> lock(injector_mutex);
+      injector.push(task);
+    }
+    wake();
+  }
+
+  void wake() {
+    epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) > 0) {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      condition.notify_all();
+    }
+  }
+
+  /// @brief Find a range to run; detached jobs only with allow_posted.
+  bool findTask(Task &task, bool allow_posted) {
+    if (tl_pool == this && tl_index >= 0 && deques[tl_index].pop(task))
+      return true;
+    // Victims are the workers plus the injector (index == thread_count).
+    const size_t victims = thread_count + 1;
+    tl_seed ^= tl_seed << 13;
+    tl_seed ^= tl_seed >> 17;
+    tl_seed ^= tl_seed << 5;
+    const size_t start = tl_seed % victims;
+    for (size_t k = 0; k < victims; ++k) {
+      size_t v = (start + k) % victims;
+      if ((int)v == tl_index && tl_pool == this) continue;
+      TaskDeque &q = v == thread_count ? injector : deques[v];
+      if (q.steal(task)) return true;
+    }
+    // Detached jobs go last so that running launches finish first.
+    if (allow_posted && tl_pool == this && tl_index >= 0 &&
+        posted_count.load(std::memory_order_acquire) != 0) {
+      std::lock_guard<std::mutex> lock(injector_mutex);
+      if (!posted.empty()) {
+        task = {posted.front(), 0, 0};
+        posted.pop_front();
+        posted_count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run(Task task) {
+    // An empty range is a detached job; its storage belongs to the submitter
+    // and may be gone as soon as invoke returns.
+    if (task.begin == task.end) {
+      task.job->invoke(task.job->ctx, 0);
+      return;
+    }
+    // Split lazily so that thieves always find the largest remaining range.
+    while (task.end - task.begin > 1) {
+      size_t mid = task.begin + (task.end - task.begin) / 2;
+      push({task.job, mid, task.end});
+      task.end = mid;
+    }
+    Job *job = task.job;
+    job->invoke(job->ctx, task.begin);
+    // Last access to job: the owner may return as soon as this hits zero.
+    job->pending.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  void workerLoop(size_t index) {
+    tl_pool = this;
+    tl_index = static_cast<int>(index);
+    tl_seed = static_cast<uint32_t>(index * 0x9e3779b9u + 1);
+
+    Task task;
+    for (;;) {
+      bool found = false;
+      for (int spin = 0; spin < kSpinCount; ++spin) {
+        if (findTask(task, true)) {
+          found = true;
+          break;
+        }
+        if (stop.load(std::memory_order_relaxed)) return;
+        std::this_thread::yield();
+      }
+      if (found) {
+        run(task);
+        continue;
+      }
+
+      uint64_t seen = epoch.load(std::memory_order_seq_cst);
+      if (findTask(task, true)) {
+        run(task);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      sleepers.fetch_add(1, std::memory_order_seq_cst);
+      condition.wait(lock, [&] {
+        return stop.load() || epoch.load(std::memory_order_seq_cst) != seen;
+      });
+      sleepers.fetch_sub(1, std::memory_order_seq_cst);
+      if (stop.load()) return;
+    }
+  }
+
  public:
-  ThreadPool(size_t threads) : stop(false) {
-    for (size_t i = 0; i < threads; ++i) {
+  ThreadPool(size_t threads)
+      : thread_count(threads), deques(new TaskDeque[threads]) {
+    workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
       workers.emplace_back([this, i] {
         // Set CPU affinity for this worker thread
         set_thread_affinity(
@@ -97,45 +341,64 @@ class ThreadPool {
                        , i, " bound to CPU core "
                        , (i % std::thread::hardware_concurrency()));
 
-        for (;;) {
-          std::function<void()> task;
-          {
-            std::unique_lock<std::mutex> lock(this->queue_mutex);
-            this->condition.wait(
-                lock, [this] { return this->stop || !this->tasks.empty(); });
-
-            if (this->stop && this->tasks.empty()) return;
-
-            task = std::move(this->tasks.front());
-            this->tasks.pop();
-          }
-          task();
-        }
+        workerLoop(i);
       });
     }
   }
 
-  template <class F>
-  auto enqueue(F&& f) -> std::future<void> {
-    using return_type = void;
+  size_t size() const { return thread_count; }
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f)));
+  /// @brief Index of the calling worker of this pool, -1 for other threads.
+  int workerIndex() const { return tl_pool == this ? tl_index : -1; }
 
-    std::future<return_type> res = task->get_future();
-    {
-      std::unique_lock<std::mutex> lock(queue_mutex);
-      if (stop) throw std::runtime_error("enqueue on stopped ThreadPool");
+  /// @brief Run fn(i) for every i in [0, count) and wait for completion.
+  /// The calling thread participates; fn must be safe to call concurrently.
+  template <typename F>
+  void parallel_for(size_t count, F &&fn) {
+    using Fn = std::remove_reference_t<F>;
+    if (count == 0) return;
+    if (count == 1 || thread_count == 0) {
+      for (size_t i = 0; i < count; ++i) fn(i);
+      return;
+    }
 
-      tasks.emplace([task]() { (*task)(); });
+    Job job;
+    job.invoke = [](const void *ctx, size_t i) {
+      (*static_cast<const Fn *>(ctx))(i);
+    };
+    job.ctx = static_cast<const void *>(std::addressof(fn));
+    job.pending.store(count, std::memory_order_relaxed);
+
+    push({&job, 0, count});
+
+    // Helping never runs a detached job: it could hold this launch up
+    // behind a whole stream queue, or park on an event signalled later
+    Task task;
+    while (job.pending.load(std::memory_order_acquire) != 0) {
+      if (findTask(task, false))
+        run(task);
+      else
+        std::this_thread::yield();
+    }
+  }
+
+  /// @brief Post a detached job; a worker calls job->invoke(job->ctx, 0).
+  void submit(Job *job) {
+    if (thread_count == 0) {
+      job->invoke(job->ctx, 0);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(injector_mutex);
+      posted.push_back(job);
+      posted_count.fetch_add(1, std::memory_order_release);
     }
-    condition.notify_one();
-    return res;
+    wake();
   }
 
   ~ThreadPool() {
     {
-      std::unique_lock<std::mutex> lock(queue_mutex);
+      std::unique_lock<std::mutex> lock(sleep_mutex);
       stop = true;
     }
     condition.notify_all();
@@ -143,4 +406,4 @@ class ThreadPool {
   }
 };
 
-#endif  // THREADPOOL_H
\ No newline at end of file
+#endif  // THREADPOOL_H
@@ -5,6 +5,9 @@
 #include <rt_command.h>
 
 class CudaCommand : public nxs::rt::Command<CUfunction, CUevent, CUstream> {
+  // Bumped whenever arguments or launch dims change
+  uint32_t revision = 0;
+
  public:
   CudaCommand(CUfunction kernel = nullptr, nxs_uint command_settings = 0)
       : Command(kernel, command_settings) {}
@@ -15,6 +18,47 @@ class CudaCommand : public nxs::rt::Command<CUfunction, CUevent, CUstream> {
 
   ~CudaCommand() = default;
 
+  nxs_status setArgument(nxs_int argument_index, nxs::rt::Buffer *buffer,
+                         const char *name = "",
+                         nxs_uint argument_settings = 0) {
+    auto status =
+        Command::setArgument(argument_index, buffer, name, argument_settings);
+    if (nxs_success(status)) ++revision;
+    return status;
+  }
+
+  nxs_status setScalar(nxs_int argument_index, void *value,
+                       const char *name = "", nxs_uint argument_settings = 0) {
+    auto status =
+        Command::setScalar(argument_index, value, name, argument_settings);
+    if (nxs_success(status)) ++revision;
+    return status;
+  }
+
+  nxs_status finalize(nxs_dim3 grid_size, nxs_dim3 block_size,
+                      nxs_uint shared_memory_size) {
+    auto status = Command::finalize(grid_size, block_size, shared_memory_size);
+    if (nxs_success(status)) ++revision;
+    return status;
+  }
+
+  uint32_t getRevision() const { return revision; }
+
+  /// @brief Launch of the dispatch as kernel node parameters, used to
+  /// update a captured graph after the arguments were rebound.
+  void getNodeParams(CUDA_KERNEL_NODE_PARAMS &params) {
+    params = {};
+    params.func = kernel;
+    params.gridDimX = grid_size.x;
+    params.gridDimY = grid_size.y;
+    params.gridDimZ = grid_size.z;
+    params.blockDimX = block_size.x;
+    params.blockDimY = block_size.y;
+    params.blockDimZ = block_size.z;
+    params.sharedMemBytes = shared_memory_size;
+    params.kernelParams = args_ref.data();
+  }
+
   nxs_status runCommand(CUstream stream) override {
     NXSAPI_LOG(nexus::NXS_LOG_NOTE, "runCommand ", kernel, " - ", type);
     switch (type) {
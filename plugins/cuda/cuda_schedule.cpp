@@ -12,6 +12,18 @@ float CudaSchedule::getTime() const {
   return 0.0f;
 }
 
+nxs_status CudaSchedule::updateGraph() {
+  for (auto &captured : captured_nodes) {
+    if (captured.command->getRevision() == captured.revision) continue;
+    CUDA_KERNEL_NODE_PARAMS params;
+    captured.command->getNodeParams(params);
+    CU_CHECK(NXS_InvalidSchedule, cuGraphExecKernelNodeSetParams, graphExec,
+             captured.node, &params);
+    captured.revision = captured.command->getRevision();
+  }
+  return NXS_Success;
+}
+
 nxs_status CudaSchedule::run(CUstream stream, nxs_uint run_settings) {
   nxs_uint settings = getSettings() | run_settings;
   if (settings & NXS_ExecutionSettings_Timing) {
@@ -24,16 +36,32 @@ nxs_status CudaSchedule::run(CUstream stream, nxs_uint run_settings) {
     CUDA_CHECK(NXS_InvalidCommand, cudaEventRecord, start_event, stream);
   }
   if (is_graph_built) {
+    auto status = updateGraph();
+    if (!nxs_success(status)) return status;
     CUDA_CHECK(NXS_InvalidSchedule, cudaGraphLaunch, graphExec, stream);
   } else {
-    if (settings & NXS_ExecutionSettings_Capture) {
+    bool capture = settings & NXS_ExecutionSettings_Capture;
+    if (capture) {
       CUDA_CHECK(NXS_InvalidSchedule, cudaStreamBeginCapture, stream,
                  cudaStreamCaptureModeGlobal);
+      captured_nodes.clear();
     }
 
     for (auto cmd : getCommands()) {
       auto status = cmd->runCommand(stream);
       if (!nxs_success(status)) return status;
+      if (!capture || cmd->getType() != NXS_CommandType_Dispatch) continue;
+      // The node just captured is the only dependency left on the stream
+      cudaStreamCaptureStatus capture_status;
+      unsigned long long capture_id;
+      cudaGraph_t capture_graph;
+      const cudaGraphNode_t *deps = nullptr;
+      size_t num_deps = 0;
+      CUDA_CHECK(NXS_InvalidSchedule, cudaStreamGetCaptureInfo, stream,
+                 &capture_status, &capture_id, &capture_graph, &deps,
+                 &num_deps);
+      if (num_deps == 1)
+        captured_nodes.push_back({cmd, deps[0], cmd->getRevision()});
     }
     if (settings & NXS_ExecutionSettings_Capture) {
       CUDA_CHECK(NXS_InvalidSchedule, cudaStreamEndCapture, stream, &graph);
@@ -64,5 +92,6 @@ nxs_status CudaSchedule::release() {
     cudaGraphDestroy(graph);
     is_graph_built = false;
   }
+  captured_nodes.clear();
   return status;
 }
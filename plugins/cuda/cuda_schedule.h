@@ -6,12 +6,25 @@
 #include <cuda_utils.h>
 #include <rt_schedule.h>
 
+#include <vector>
+
 class CudaSchedule : public nxs::rt::Schedule<CudaCommand, CudaDevice *, CUstream> {
   bool is_graph_built;
   cudaGraph_t graph;
   cudaGraphExec_t graphExec;
   CUevent start_event, end_event;
 
+  // Kernel node of each captured dispatch and the command revision it
+  // holds; rebound commands are pushed into graphExec before a launch
+  struct CapturedNode {
+    CudaCommand *command;
+    cudaGraphNode_t node;
+    uint32_t revision;
+  };
+  std::vector<CapturedNode> captured_nodes;
+
+  nxs_status updateGraph();
+
  public:
   CudaSchedule(CudaDevice *device = nullptr, nxs_uint settings = 0)
       : Schedule(device, settings),
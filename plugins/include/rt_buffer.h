@@ -2,8 +2,12 @@
 #define RT_BUFFER_H
 
 #include <nexus-api.h>
+#include <rt_host_memory.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <utility>
 
 namespace nxs {
 namespace rt {
@@ -13,6 +17,11 @@ class Buffer {
   nxs_buffer_layout layout;
   size_t size_bytes;
   nxs_uint settings;
+  HostMemory memory;  // backing of a maintained buffer
+  // Views share (and hold a reference on) their parent's memory
+  Buffer *parent = nullptr;
+  size_t offset = 0;
+  std::atomic<nxs_int> refs{1};
 
  public:
   Buffer(const nxs_buffer_layout &layout, void *data_ptr = nullptr,
@@ -20,10 +29,30 @@ class Buffer {
       : buf((char *)data_ptr), layout(layout), size_bytes(0), settings(settings) {
     setSizeBytes();
     if (settings & NXS_BufferSettings_Maintain) {
-      buf = (char *)malloc(getSizeBytes());
-      if (data_ptr) std::memcpy((void *)buf, data_ptr, getSizeBytes());
+      memory = allocateHostMemory(getSizeBytes(), settings);
+      buf = (char *)memory.ptr;
+      if (buf && data_ptr) std::memcpy((void *)buf, data_ptr, getSizeBytes());
     }
   }
+  /// @brief Maintained buffer on memory allocated by the caller; the buffer
+  /// takes ownership unless it is detached again (detachMemory).
+  Buffer(const nxs_buffer_layout &layout, const HostMemory &host_memory,
+         void *data_ptr, nxs_uint settings)
+      : buf((char *)host_memory.ptr), layout(layout), size_bytes(0),
+        settings(settings | NXS_BufferSettings_Maintain), memory(host_memory) {
+    setSizeBytes();
+    if (buf && data_ptr) std::memcpy((void *)buf, data_ptr, getSizeBytes());
+  }
+  /// @brief View of `parent` starting `offset` bytes in; layout gives its
+  /// dims and element strides. The view retains the parent.
+  Buffer(Buffer *parent, size_t offset, const nxs_buffer_layout &layout,
+         nxs_uint settings = 0)
+      : buf(parent->data() + offset), layout(layout), size_bytes(0),
+        settings(settings & ~NXS_BufferSettings_Maintain), parent(parent),
+        offset(offset) {
+    setSizeBytes();
+    parent->retain();
+  }
   Buffer(size_t size=0, void *data_ptr = nullptr, nxs_uint settings = 0)
       : Buffer(nxs_buffer_layout{
                    (nxs_uint)NXS_DataType_Undefined,
@@ -33,31 +62,106 @@ class Buffer {
                data_ptr, settings) {}
   ~Buffer() { release(); }
   void release() {
-    if (buf && settings & NXS_BufferSettings_Maintain)
-      free(buf);
+    if (settings & NXS_BufferSettings_Maintain) freeHostMemory(memory);
     buf = nullptr;
+    parent = nullptr;
+    offset = 0;
     layout = nxs_buffer_layout{(nxs_uint)NXS_DataType_Undefined, 0, {0}, {0}};
     size_bytes = 0;
   }
+  /// @brief Give up the backing memory of a maintained buffer, e.g. to
+  /// cache it; the buffer is left empty.
+  HostMemory detachMemory() {
+    HostMemory detached;
+    if (settings & NXS_BufferSettings_Maintain) std::swap(detached, memory);
+    release();
+    return detached;
+  }
+  Buffer *getParent() const { return parent; }
+  size_t getOffset() const { return offset; }
+  void retain() { refs.fetch_add(1, std::memory_order_relaxed); }
+  /// @brief Drop a reference; true when it was the last one and the buffer
+  /// (then its parent) should be released.
+  bool drop() { return refs.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
   char *data() const { return buf; }
   char *getData() const { return buf; }
   size_t getSizeBytes() const { return size_bytes; }
-  void setSizeBytes() {
-    size_bytes = getNumElements();
-    if (auto element_size_bits = getElementSizeBits()) {
-      size_bytes *= element_size_bits;
-      size_bytes /= 8;
+  static size_t getSizeBytes(const nxs_buffer_layout &layout) {
+    size_t size = nxsGetNumElements(layout);
+    if (auto element_size_bits = nxsGetDataTypeSizeBits(layout.data_type)) {
+      size *= element_size_bits;
+      size /= 8;
     }
+    return size;
   }
-  void setSizeBytes(size_t new_size_bytes) {
-    auto *buf_c = buf;
-    if (settings & NXS_BufferSettings_Maintain) {
-      buf = (char *)realloc(buf, new_size_bytes);
-    } else {
-      settings |= NXS_BufferSettings_Maintain;
-      buf = (char *)malloc(new_size_bytes);
-      if (buf_c) std::memcpy((void *)buf, buf_c, std::min(size_bytes, new_size_bytes));
+  /// @brief True if the layout packs its elements without gaps in dim 0
+  /// order (the order of forEachRun); all-zero strides (the legacy default)
+  /// count as packed. A dense but permuted layout is not contiguous.
+  static bool isContiguous(const nxs_buffer_layout &layout) {
+    bool strided = false;
+    for (nxs_uint i = 0; i < layout.rank; ++i)
+      strided |= layout.stride[i] != 0;
+    if (!strided) return true;
+    nxs_ulong expected = 1;
+    for (nxs_uint i = 0; i < layout.rank; ++i) {
+      if (layout.dim[i] <= 1) continue;
+      if (layout.stride[i] != expected) return false;
+      expected *= layout.dim[i];
+    }
+    return true;
+  }
+  /// @brief Bytes from the first to one past the last element.
+  static size_t getExtentBytes(const nxs_buffer_layout &layout) {
+    if (isContiguous(layout)) return getSizeBytes(layout);
+    nxs_ulong last = 0;
+    for (nxs_uint i = 0; i < layout.rank; ++i) {
+      if (layout.dim[i] == 0) return 0;
+      last += (layout.dim[i] - 1) * layout.stride[i];
+    }
+    return (last + 1) * nxsGetDataTypeSizeBits(layout.data_type) / 8;
+  }
+  bool isContiguous() const { return isContiguous(layout); }
+  size_t getExtentBytes() const { return getExtentBytes(layout); }
+
+  /// @brief Call fn(ptr, bytes, packed_offset) for every run of adjacent
+  /// elements in dim 0 order; packed_offset is where the run goes in a
+  /// densely packed copy. False for sub-byte elements in a strided layout.
+  template <typename F>
+  bool forEachRun(F &&fn) const {
+    if (isContiguous()) {
+      if (size_bytes) fn(buf, size_bytes, size_t(0));
+      return true;
+    }
+    // a zero dim leaves no element to visit
+    if (getNumElements() == 0) return true;
+    size_t elem_bits = getElementSizeBits();
+    if (elem_bits == 0 || elem_bits % 8) return false;
+    size_t elem = elem_bits / 8;
+    nxs_uint rank = layout.rank;
+    size_t run = layout.stride[0] == 1 ? layout.dim[0] : 1;
+    nxs_ulong index[NXS_MAX_DIMS] = {};
+    size_t packed = 0;
+    for (;;) {
+      size_t pos = 0;
+      for (nxs_uint i = 0; i < rank; ++i) pos += index[i] * layout.stride[i];
+      fn(buf + pos * elem, run * elem, packed);
+      packed += run * elem;
+      // advance the odometer past the run
+      nxs_uint d = run > 1 ? 1 : 0;
+      while (d < rank && ++index[d] == layout.dim[d]) index[d++] = 0;
+      if (d == rank) return true;
     }
+  }
+  void setSizeBytes() { size_bytes = getSizeBytes(layout); }
+  void setSizeBytes(size_t new_size_bytes) {
+    auto new_memory = allocateHostMemory(new_size_bytes, settings);
+    if (buf && new_memory.ptr)
+      std::memcpy(new_memory.ptr, buf, std::min(size_bytes, new_size_bytes));
+    if (settings & NXS_BufferSettings_Maintain) freeHostMemory(memory);
+    settings |= NXS_BufferSettings_Maintain;
+    memory = new_memory;
+    buf = (char *)memory.ptr;
     layout = nxs_buffer_layout{(nxs_uint)NXS_DataType_Undefined, 1,
                                {new_size_bytes}, {0}};
     size_bytes = new_size_bytes;
@@ -71,6 +175,22 @@ class Buffer {
     return (nxs_data_type)layout.data_type;
   }
   nxs_uint getSettings() const { return settings; }
+  bool isMaintained() const { return settings & NXS_BufferSettings_Maintain; }
+  /// @brief Alignment of the data; for an aliased host pointer, the largest
+  /// power of two dividing it, up to a page.
+  size_t getAlignment() const {
+    if (isMaintained()) return memory.alignment;
+    size_t page = getSystemPageSize();
+    return buf ? std::min(page, (size_t)((uintptr_t)buf & -(uintptr_t)buf))
+               : page;
+  }
+  size_t getPageSize() const {
+    return isMaintained() ? memory.page_size : getSystemPageSize();
+  }
+  const char *getPlacementName() const {
+    return HostMemory::getPlacementName(
+        isMaintained() ? memory.placement : HostMemory::Default);
+  }
   void setSettings(nxs_uint new_settings) {
     settings = new_settings;
   }
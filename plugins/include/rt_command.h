@@ -59,6 +59,9 @@ class Command {
 
   nxs_command_type getType() const { return type; }
 
+  Tevent getEvent() const { return event; }
+  nxs_int getEventValue() const { return event_value; }
+
   float getTime() const { return time_ms; }
 
   int getArgsCount() const { return args_count; }
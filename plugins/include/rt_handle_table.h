@@ -0,0 +1,213 @@
+#ifndef RT_HANDLE_TABLE_H
+#define RT_HANDLE_TABLE_H
+
+#include <nexus-api.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace nxs {
+namespace rt {
+
+/**
+ * Generation-tagged handle table
+ *
+ * Maps nxs_int handles to slots of T without a lock:
+ *  - acquire/release pop/push a Treiber free list whose head carries an ABA
+ *    tag, falling back to bumping a tail index,
+ *  - lookup is wait-free: two loads and a tag compare.
+ *
+ * A handle is `generation << slot_bits | slot`. Every release bumps the
+ * generation of the slot, so stale or double-released handles fail the tag
+ * compare instead of aliasing a newer object. The first use of a slot has
+ * generation 0, so the first handles handed out are 0, 1, 2, ... as before.
+ *
+ * Handles are 31 bits, so generations wrap after 2^generation_bits reuses
+ * of a slot. Rather than wrap, a slot whose generation is exhausted is
+ * retired; retired slots restart at generation 0 only once no free or
+ * untouched slot is left, i.e. after about 2^31 handles have been issued.
+ * A stale handle can therefore only alias a live object after that many
+ * further acquisitions.
+ *
+ * Slots live in fixed-size segments that are allocated on demand and never
+ * move, so a T* stays valid until its handle is released.
+ */
+template <typename T, size_t segment_size = 1024>
+class HandleTable {
+ public:
+  static constexpr int slot_bits = 20;
+  static constexpr int generation_bits = 31 - slot_bits;
+  static constexpr uint32_t slot_mask = (1u << slot_bits) - 1;
+  static constexpr uint32_t generation_mask = (1u << generation_bits) - 1;
+  static constexpr size_t max_slots = size_t(1) << slot_bits;
+
+ private:
+  static_assert((segment_size & (segment_size - 1)) == 0,
+                "segment_size must be a power of two");
+  static constexpr size_t num_segments = max_slots / segment_size;
+  static constexpr uint32_t live_bit = 1;
+  static constexpr uint32_t no_slot = ~0u;
+
+  struct Slot {
+    // generation << 1 | live
+    std::atomic<uint32_t> tag{0};
+    std::atomic<uint32_t> next_free{no_slot};
+    T value;
+  };
+
+  std::array<std::atomic<Slot *>, num_segments> segments_{};
+  // free list heads: ABA counter << 32 | slot index
+  std::atomic<uint64_t> free_head_{no_slot};
+  std::atomic<uint64_t> retired_head_{no_slot};
+  std::atomic<uint32_t> tail_{0};
+  std::atomic<int32_t> live_count_{0};
+
+  Slot *getSlot(uint32_t index) const {
+    auto *segment =
+        segments_[index / segment_size].load(std::memory_order_acquire);
+    return segment ? &segment[index % segment_size] : nullptr;
+  }
+
+  Slot *makeSlot(uint32_t index) {
+    auto &entry = segments_[index / segment_size];
+    auto *segment = entry.load(std::memory_order_acquire);
+    if (!segment) {
+      auto *fresh = new Slot[segment_size];
+      if (entry.compare_exchange_strong(segment, fresh,
+                                        std::memory_order_acq_rel))
+        segment = fresh;
+      else
+        delete[] fresh;
+    }
+    return &segment[index % segment_size];
+  }
+
+  uint32_t popFree(std::atomic<uint64_t> &list) {
+    uint64_t head = list.load(std::memory_order_acquire);
+    while (uint32_t(head) != no_slot) {
+      auto *slot = getSlot(uint32_t(head));
+      uint64_t next = ((head >> 32) + 1) << 32 |
+                      slot->next_free.load(std::memory_order_relaxed);
+      if (list.compare_exchange_weak(head, next, std::memory_order_acq_rel))
+        return uint32_t(head);
+    }
+    return no_slot;
+  }
+
+  void pushFree(std::atomic<uint64_t> &list, uint32_t index, Slot *slot) {
+    uint64_t head = list.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+      slot->next_free.store(uint32_t(head), std::memory_order_relaxed);
+      next = ((head >> 32) + 1) << 32 | index;
+    } while (!list.compare_exchange_weak(head, next, std::memory_order_release,
+                                         std::memory_order_relaxed));
+  }
+
+  static nxs_int makeHandle(uint32_t index, uint32_t tag) {
+    return nxs_int(((tag >> 1) & generation_mask) << slot_bits | index);
+  }
+
+  static bool matches(uint32_t tag, nxs_int handle) {
+    return (tag & live_bit) &&
+           ((tag >> 1) & generation_mask) == uint32_t(handle) >> slot_bits;
+  }
+
+ public:
+  HandleTable() = default;
+  HandleTable(const HandleTable &) = delete;
+  HandleTable &operator=(const HandleTable &) = delete;
+
+  ~HandleTable() {
+    for (auto &entry : segments_) delete[] entry.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Construct a T in a free slot
+   * @return Handle of the new object, -1 if the table is full
+   */
+  template <typename... Args>
+  nxs_int acquire(Args &&...args) {
+    uint32_t index = popFree(free_head_);
+    Slot *slot;
+    if (index != no_slot) {
+      slot = getSlot(index);
+    } else {
+      index = tail_.fetch_add(1, std::memory_order_relaxed);
+      if (index < max_slots) {
+        slot = makeSlot(index);
+      } else {
+        tail_.fetch_sub(1, std::memory_order_relaxed);
+        // every slot was used; only now do retired ones wrap to generation 0
+        index = popFree(retired_head_);
+        if (index == no_slot) return -1;
+        slot = getSlot(index);
+      }
+    }
+    slot->value = T(std::forward<Args>(args)...);
+    uint32_t tag = slot->tag.load(std::memory_order_relaxed) | live_bit;
+    slot->tag.store(tag, std::memory_order_release);
+    live_count_.fetch_add(1, std::memory_order_relaxed);
+    return makeHandle(index, tag);
+  }
+
+  /**
+   * Look up a live handle
+   * @return Pointer to the object, nullptr for invalid or stale handles
+   */
+  T *get(nxs_int handle) const {
+    if (handle < 0) return nullptr;
+    auto *slot = getSlot(uint32_t(handle) & slot_mask);
+    if (!slot || !matches(slot->tag.load(std::memory_order_acquire), handle))
+      return nullptr;
+    return &slot->value;
+  }
+
+  /**
+   * Release a handle, running `fn` on the object first
+   * @return false if the handle is invalid or was already released
+   */
+  template <typename Fn>
+  bool release(nxs_int handle, Fn &&fn) {
+    if (handle < 0) return false;
+    uint32_t index = uint32_t(handle) & slot_mask;
+    auto *slot = getSlot(index);
+    if (!slot) return false;
+    uint32_t tag = slot->tag.load(std::memory_order_acquire);
+    uint32_t next;
+    do {
+      if (!matches(tag, handle)) return false;
+      next = (tag + 2) & ~live_bit & (generation_mask << 1);
+    } while (!slot->tag.compare_exchange_weak(tag, next,
+                                              std::memory_order_acq_rel));
+    fn(slot->value);
+    slot->value = T();
+    live_count_.fetch_sub(1, std::memory_order_relaxed);
+    // the generation wrapped: park the slot instead of reissuing old ids
+    pushFree(next ? free_head_ : retired_head_, index, slot);
+    return true;
+  }
+
+  bool release(nxs_int handle) {
+    return release(handle, [](T &) {});
+  }
+
+  /**
+   * Upper bound of slot indices handed out so far
+   */
+  size_t capacity() const { return tail_.load(std::memory_order_relaxed); }
+
+  /**
+   * Number of live handles
+   */
+  size_t get_in_use_count() const {
+    return live_count_.load(std::memory_order_relaxed);
+  }
+};
+
+}  // namespace rt
+}  // namespace nxs
+
+#endif  // RT_HANDLE_TABLE_H
@@ -0,0 +1,175 @@
+#ifndef RT_HOST_MEMORY_H
+#define RT_HOST_MEMORY_H
+
+#include <nexus-api.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace nxs {
+namespace rt {
+
+/**
+ * Host allocation backing a maintained rt::Buffer
+ *
+ * Heap allocations are aligned to 64 bytes (or a page with
+ * NXS_BufferSettings_AlignPage). NXS_BufferSettings_HugePages and
+ * NXS_BufferSettings_Interleave map the memory directly: huge pages come
+ * from MAP_HUGETLB when the system has them reserved and from
+ * madvise(MADV_HUGEPAGE) otherwise, interleaving binds the range across all
+ * online NUMA nodes. Every request degrades to the next best thing rather
+ * than failing; the fields record what was actually applied.
+ */
+struct HostMemory {
+  enum Kind : uint8_t { None, Heap, Mapped };
+  enum Placement : uint8_t { Default, FirstTouch, Interleave };
+
+  void *ptr = nullptr;
+  size_t bytes = 0;  // length of the allocation
+  size_t alignment = 0;
+  size_t page_size = 0;
+  Kind kind = None;
+  Placement placement = Default;
+
+  static const char *getPlacementName(Placement placement) {
+    switch (placement) {
+      case FirstTouch: return "first-touch";
+      case Interleave: return "interleave";
+      default: return "default";
+    }
+  }
+};
+
+constexpr size_t kHostMemoryAlignment = 64;
+constexpr size_t kHugePageSize = size_t(2) << 20;
+
+inline size_t getSystemPageSize() {
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+}
+
+inline size_t roundUp(size_t size, size_t align) {
+  return (size + align - 1) / align * align;
+}
+
+namespace detail {
+
+#if defined(__linux__)
+// Bind [ptr, ptr + bytes) round-robin across the online NUMA nodes, without
+// depending on libnuma
+inline bool interleaveNodes(void *ptr, size_t bytes) {
+  static const unsigned long node_mask = [] {
+    unsigned long mask = 0;
+    if (FILE *f = std::fopen("/sys/devices/system/node/online", "r")) {
+      unsigned first, last;
+      int n;
+      while ((n = std::fscanf(f, "%u-%u", &first, &last)) >= 1) {
+        if (n == 1) last = first;
+        for (unsigned node = first; node <= last && node < 64; ++node)
+          mask |= 1ul << node;
+        if (std::fgetc(f) != ',') break;
+      }
+      std::fclose(f);
+    }
+    return mask;
+  }();
+  if (!node_mask) return false;
+  const int mpol_interleave = 3;
+  return syscall(SYS_mbind, ptr, bytes, mpol_interleave, &node_mask,
+                 sizeof(node_mask) * 8 + 1, 0) == 0;
+}
+#endif
+
+inline bool mapHostMemory(HostMemory &mem, size_t size, nxs_uint settings) {
+  size_t page = getSystemPageSize();
+  bool huge = settings & NXS_BufferSettings_HugePages;
+  size_t bytes = roundUp(size, huge ? kHugePageSize : page);
+  void *ptr = MAP_FAILED;
+  mem.page_size = page;
+  mem.alignment = page;
+#if defined(MAP_HUGETLB)
+  if (huge) {
+    ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED) mem.page_size = mem.alignment = kHugePageSize;
+  }
+#endif
+  if (ptr == MAP_FAILED && huge) {
+    // Over-map and trim to a huge page boundary so THP can back it
+    size_t span = bytes + kHugePageSize;
+    char *raw = (char *)mmap(nullptr, span, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == (char *)MAP_FAILED) return false;
+    char *aligned = (char *)roundUp((uintptr_t)raw, kHugePageSize);
+    if (aligned != raw) munmap(raw, aligned - raw);
+    if (size_t tail = (raw + span) - (aligned + bytes))
+      munmap(aligned + bytes, tail);
+    ptr = aligned;
+    mem.alignment = kHugePageSize;
+#if defined(MADV_HUGEPAGE)
+    if (madvise(ptr, bytes, MADV_HUGEPAGE) == 0) mem.page_size = kHugePageSize;
+#endif
+  }
+  if (ptr == MAP_FAILED) {
+    ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) return false;
+  }
+  mem.ptr = ptr;
+  mem.bytes = bytes;
+  mem.kind = HostMemory::Mapped;
+#if defined(__linux__)
+  if ((settings & NXS_BufferSettings_Interleave) && interleaveNodes(ptr, bytes))
+    mem.placement = HostMemory::Interleave;
+#endif
+  return true;
+}
+
+}  // namespace detail
+
+/**
+ * Allocate host memory for `size` bytes as selected by the buffer settings
+ * @return Allocation, with ptr == nullptr when out of memory
+ */
+inline HostMemory allocateHostMemory(size_t size, nxs_uint settings) {
+  HostMemory mem;
+  if (size == 0) size = 1;
+  if (settings & NXS_BufferSettings_FirstTouch)
+    mem.placement = HostMemory::FirstTouch;
+  if ((settings & (NXS_BufferSettings_HugePages |
+                   NXS_BufferSettings_Interleave)) &&
+      detail::mapHostMemory(mem, size, settings))
+    return mem;
+
+  size_t page = getSystemPageSize();
+  mem.alignment = (settings & NXS_BufferSettings_AlignPage)
+                      ? page
+                      : kHostMemoryAlignment;
+  mem.page_size = page;
+  mem.bytes = roundUp(size, mem.alignment);
+  if (posix_memalign(&mem.ptr, mem.alignment, mem.bytes) != 0)
+    return HostMemory();
+  mem.kind = HostMemory::Heap;
+  return mem;
+}
+
+inline void freeHostMemory(HostMemory &mem) {
+  if (mem.kind == HostMemory::Heap)
+    free(mem.ptr);
+  else if (mem.kind == HostMemory::Mapped)
+    munmap(mem.ptr, mem.bytes);
+  mem = HostMemory();
+}
+
+}  // namespace rt
+}  // namespace nxs
+
+#endif  // RT_HOST_MEMORY_H
@@ -40,7 +40,8 @@ class Object {
 
   template <typename T = void>
   T *get() const {
-    return static_cast<T *>(std::get<void *>(obj));
+    if (auto *ptr = std::get_if<void *>(&obj)) return static_cast<T *>(*ptr);
+    return nullptr;
   }
   nxs_long getValue() const { return std::get<nxs_long>(obj); }
 
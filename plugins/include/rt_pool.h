@@ -3,6 +3,8 @@
 
 #include <nexus-api.h>
 
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <functional>
 #include <memory>
@@ -13,61 +15,216 @@
 namespace nxs {
 namespace rt {
 
+/**
+ * Small per-thread tag, used by Pool to spot objects released by a thread
+ * other than the one that acquired them
+ */
+inline uint32_t poolThreadTag() {
+  static std::atomic<uint32_t> next_tag{1};
+  static thread_local uint32_t tag = next_tag.fetch_add(1);
+  return tag;
+}
+
 /**
  * Template class for object pooling
  * Provides efficient allocation and deallocation of objects by reusing them
- * Pool owns all objects and manages them in vector-based storage
+ * Pool owns all objects and manages them in chunked storage
+ *
+ * Chunks are allocated once and never move, so object pointers stay valid
+ * for the lifetime of the pool. Each object is stored with its index, so
+ * releasing by pointer needs no search. Free indices live in a shared depot behind
+ * a mutex; every thread keeps a small magazine of indices per pool in front
+ * of it, refilled from and flushed to the depot in batches, so acquire and
+ * release normally do not touch shared state at all.
  */
 template <typename T, size_t chunk_size = 1024>
 class Pool {
+ public:
+  static constexpr size_t max_chunks = 4096;
+  static constexpr size_t magazine_size = 32;
+  static constexpr size_t refill_batch = magazine_size / 2;
+
+  /**
+   * Magazine statistics, folded into the pool whenever a thread refills or
+   * flushes its magazine (see flush_local)
+   */
+  struct Stats {
+    uint64_t hits;                // acquires served by a magazine
+    uint64_t misses;              // acquires that refilled from the depot
+    uint64_t cross_thread_frees;  // releases by a thread that did not acquire
+    uint64_t flushes;             // magazine flushes to the depot
+    double hit_rate() const {
+      return hits + misses ? double(hits) / double(hits + misses) : 0.0;
+    }
+  };
+
  private:
-  typedef std::array<T, chunk_size> Chunk;
-  std::vector<Chunk> object_storage_;       // Owns all objects
-  std::vector<nxs_int> available_indices_;  // Indices of available objects
-  std::mutex pool_mutex_;
-  nxs_int tail_index_;
+  // The object comes first, so a T* from the pool points at its slot
+  struct Slot {
+    T object;
+    nxs_int index = -1;  // set when the object is handed out
+  };
+
+  struct Chunk {
+    std::array<Slot, chunk_size> slots;
+    std::array<std::atomic<uint32_t>, chunk_size> owners{};
+  };
+
+  struct Depot {
+    std::mutex mutex;
+    std::vector<nxs_int> available_indices;
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> cross_thread_frees{0};
+    std::atomic<uint64_t> flushes{0};
+  };
+
+  struct Magazine {
+    uint64_t serial = 0;  // pool serial, 0 when unused
+    std::weak_ptr<Depot> depot;
+    size_t count = 0;
+    std::array<nxs_int, magazine_size> indices;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t cross_thread_frees = 0;
+
+    // Return `n` indices (and the local statistics) to the owning depot;
+    // indices of a destroyed pool are dropped
+    void flush(size_t n, Depot *live = nullptr) {
+      std::shared_ptr<Depot> locked;
+      if (!live) {
+        locked = depot.lock();
+        live = locked.get();
+      }
+      if (live) {
+        std::lock_guard<std::mutex> lock(live->mutex);
+        live->available_indices.insert(live->available_indices.end(),
+                                       indices.begin() + (count - n),
+                                       indices.begin() + count);
+        live->hits.fetch_add(hits, std::memory_order_relaxed);
+        live->misses.fetch_add(misses, std::memory_order_relaxed);
+        live->cross_thread_frees.fetch_add(cross_thread_frees,
+                                           std::memory_order_relaxed);
+        live->flushes.fetch_add(1, std::memory_order_relaxed);
+      }
+      count -= n;
+      hits = misses = cross_thread_frees = 0;
+    }
+  };
+
+  // Magazines of the calling thread, for up to `local_pools` pools of this
+  // type; threads flush them back when they exit
+  static constexpr size_t local_pools = 4;
+  struct LocalCache {
+    std::array<Magazine, local_pools> magazines;
+    size_t victim = 0;
+    ~LocalCache() {
+      for (auto &mag : magazines)
+        if (mag.serial) mag.flush(mag.count);
+    }
+  };
+
+  static uint64_t nextSerial() {
+    static std::atomic<uint64_t> next_serial{1};
+    return next_serial.fetch_add(1);
+  }
+
+  std::array<std::atomic<Chunk *>, max_chunks> chunks_{};
+  std::shared_ptr<Depot> depot_;
+  std::atomic<nxs_int> tail_index_;
+  uint64_t serial_;
 
   std::pair<nxs_int, nxs_int> getIndexPair(nxs_int index) {
     if (index < 0) return {-1, -1};
     return {index / chunk_size, index % chunk_size};
   }
 
-  Chunk& getChunk(nxs_int index) { return object_storage_[index]; }
+  Chunk &getChunk(nxs_int index) {
+    return *chunks_[index].load(std::memory_order_acquire);
+  }
+
+  Magazine &localMagazine() {
+    static thread_local LocalCache cache;
+    for (auto &mag : cache.magazines)
+      if (mag.serial == serial_) return mag;
+    Magazine *slot = nullptr;
+    for (auto &mag : cache.magazines)
+      if (!mag.serial) {
+        slot = &mag;
+        break;
+      }
+    if (!slot) {
+      slot = &cache.magazines[cache.victim++ % local_pools];
+      slot->flush(slot->count);
+    }
+    slot->serial = serial_;
+    slot->depot = depot_;
+    return *slot;
+  }
+
+  // Move a batch of free indices into `mag`, carving new ones off the tail
+  // (allocating a chunk) when the depot is empty. Called with the depot
+  // locked.
+  void refill(Magazine &mag) {
+    auto &avail = depot_->available_indices;
+    while (mag.count < refill_batch && !avail.empty()) {
+      mag.indices[mag.count++] = avail.back();
+      avail.pop_back();
+    }
+    if (mag.count) return;
+    nxs_int tail = tail_index_.load(std::memory_order_relaxed);
+    size_t chunk_index = tail / chunk_size;
+    if (chunk_index >= max_chunks) return;
+    if (!chunks_[chunk_index].load(std::memory_order_relaxed))
+      chunks_[chunk_index].store(new Chunk(), std::memory_order_release);
+    // never hand out a partial batch that straddles a chunk
+    nxs_int end = std::min<nxs_int>(tail + refill_batch,
+                                    (chunk_index + 1) * chunk_size);
+    for (nxs_int index = end; index-- > tail;) mag.indices[mag.count++] = index;
+    tail_index_.store(end, std::memory_order_release);
+  }
 
  public:
   /**
    * Constructor
-   * @param initial_capacity Initial capacity for the pool
    */
-  explicit Pool() : tail_index_(0) { object_storage_.push_back(Chunk()); }
+  explicit Pool()
+      : depot_(std::make_shared<Depot>()),
+        tail_index_(0),
+        serial_(nextSerial()) {}
+
+  Pool(const Pool &) = delete;
+  Pool &operator=(const Pool &) = delete;
 
   ~Pool() { clear(); }
 
   /**
    * Get an object from the pool
-   * @return Raw pointer to an object (pool maintains ownership)
+   * @return Index of the object (pool maintains ownership), -1 if the pool
+   *         is exhausted
    */
   template <typename... Args>
   nxs_int acquire(Args&&... args) {
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-
-    // First try to reuse an available object
-    if (!available_indices_.empty()) {
-      nxs_int index = available_indices_.back();
-      available_indices_.pop_back();
-      auto [chunk_index, chunk_offset] = getIndexPair(index);
-      auto& chunk = getChunk(chunk_index);
-      new (&chunk[chunk_offset]) T(std::forward<Args>(args)...);
-      return index;
+    auto &mag = localMagazine();
+    if (mag.count) {
+      mag.hits++;
+    } else {
+      mag.misses++;
+      std::lock_guard<std::mutex> lock(depot_->mutex);
+      refill(mag);
+      if (!mag.count) return -1;
     }
-
-    auto [chunk_index, chunk_offset] = getIndexPair(tail_index_);
-    if (chunk_index >= object_storage_.size()) {
-      object_storage_.push_back(Chunk());
-    }
-    auto& chunk = getChunk(chunk_index);
-    new (&chunk[chunk_offset]) T(std::forward<Args>(args)...);
-    return tail_index_++;
+    nxs_int index = mag.indices[--mag.count];
+    auto [chunk_index, chunk_offset] = getIndexPair(index);
+    auto &chunk = getChunk(chunk_index);
+    auto &slot = chunk.slots[chunk_offset];
+    slot.index = index;
+    T *obj = &slot.object;
+    obj->~T();
+    new (obj) T(std::forward<Args>(args)...);
+    chunk.owners[chunk_offset].store(poolThreadTag(),
+                                     std::memory_order_relaxed);
+    return index;
   }
 
   template <typename... Args>
@@ -78,24 +235,12 @@ class Pool {
 
   /**
    * Return an object to the pool
-   * @param obj Pointer to object to release
+   * @param obj Pointer to an object acquired from this pool
    */
   void release(T* obj) {
     if (!obj) return;
-
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-
-    // Find the index of the object
-    nxs_int chunk_index = 0;
-    for (auto& chunk : object_storage_) {
-      auto chunk_offset = obj - &chunk[0];
-      if (chunk_offset >= 0 && chunk_offset < chunk_size) {
-        // obj->~T();
-        available_indices_.push_back(chunk_index * chunk_size + chunk_offset);
-        return;
-      }
-      chunk_index++;
-    }
+    nxs_int index = reinterpret_cast<const Slot *>(obj)->index;
+    if (get(index) == obj) release(index);
   }
 
   /**
@@ -103,60 +248,96 @@ class Pool {
    * @param index Index of object to release
    */
   void release(nxs_int index) {
-    if (index < 0 || index >= tail_index_) return;
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-    auto* obj = get(index);
-    // if (obj) obj->~T();
-    available_indices_.push_back(index);
+    if (index < 0 || index >= tail_index_.load(std::memory_order_acquire))
+      return;
+    auto [chunk_index, chunk_offset] = getIndexPair(index);
+    auto &mag = localMagazine();
+    if (getChunk(chunk_index).owners[chunk_offset].load(
+            std::memory_order_relaxed) != poolThreadTag())
+      mag.cross_thread_frees++;
+    if (mag.count == magazine_size) mag.flush(refill_batch, depot_.get());
+    mag.indices[mag.count++] = index;
   }
 
   T* get(nxs_int index) {
-    if (index < 0 || index >= tail_index_) return nullptr;
+    if (index < 0 || index >= tail_index_.load(std::memory_order_acquire))
+      return nullptr;
     auto [chunk_index, chunk_offset] = getIndexPair(index);
-    auto& chunk = getChunk(chunk_index);
-    return &chunk[chunk_offset];
+    auto &chunk = getChunk(chunk_index);
+    return &chunk.slots[chunk_offset].object;
+  }
+
+  /**
+   * Return the calling thread's magazine to the depot, folding its
+   * statistics into the pool
+   */
+  void flush_local() {
+    auto &mag = localMagazine();
+    mag.flush(mag.count, depot_.get());
   }
 
   /**
    * Get current pool statistics
-   * @return Pair of (available objects, total objects)
+   * @return Pair of (available objects in the depot, total chunks)
    */
   std::pair<size_t, size_t> get_stats() {
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-    return {available_indices_.size(), object_storage_.size()};
+    std::lock_guard<std::mutex> lock(depot_->mutex);
+    return {depot_->available_indices.size(),
+            (capacity() + chunk_size - 1) / chunk_size};
+  }
+
+  /**
+   * Get magazine statistics folded in so far
+   */
+  Stats get_cache_stats() const {
+    return {depot_->hits.load(std::memory_order_relaxed),
+            depot_->misses.load(std::memory_order_relaxed),
+            depot_->cross_thread_frees.load(std::memory_order_relaxed),
+            depot_->flushes.load(std::memory_order_relaxed)};
   }
 
   /**
    * Clear all objects from the pool
+   * The depot is replaced, so magazines still holding indices of the old
+   * objects flush them into the dead one, where they are dropped
    */
   void clear() {
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-    object_storage_.clear();
-    available_indices_.clear();
+    auto old_depot = depot_;
+    std::lock_guard<std::mutex> lock(old_depot->mutex);
+    for (auto &chunk : chunks_) delete chunk.exchange(nullptr);
+    depot_ = std::make_shared<Depot>();
+    tail_index_.store(0, std::memory_order_release);
+    serial_ = nextSerial();
   }
 
   /**
-   * Reserve capacity for the pool
-   * @param capacity New capacity to reserve
+   * Allocate chunks up front
+   * @param capacity Number of objects to make room for
    */
   void reserve(size_t capacity) {
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-    object_storage_.reserve(capacity);
+    std::lock_guard<std::mutex> lock(depot_->mutex);
+    size_t num_chunks = std::min(max_chunks, (capacity + chunk_size - 1) /
+                                                 chunk_size);
+    for (size_t i = 0; i < num_chunks; ++i)
+      if (!chunks_[i].load(std::memory_order_relaxed))
+        chunks_[i].store(new Chunk(), std::memory_order_release);
   }
 
   /**
    * Get current capacity of the pool
-   * @return Current capacity
+   * @return Number of object slots handed out so far
    */
-  size_t capacity() const { return tail_index_; }
+  size_t capacity() const {
+    return tail_index_.load(std::memory_order_acquire);
+  }
 
   /**
    * Get total number of objects currently in use
-   * @return Number of objects in use
+   * @return Number of objects in use or cached in thread magazines
    */
   size_t get_in_use_count() {
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-    return object_storage_.size() - available_indices_.size();
+    std::lock_guard<std::mutex> lock(depot_->mutex);
+    return capacity() - depot_->available_indices.size();
   }
 
   /**
@@ -166,13 +347,18 @@ class Pool {
    */
   bool owns_object(const T* obj) {
     if (!obj) return false;
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-    return obj >= &object_storage_[0] &&
-           obj < &object_storage_[0] + object_storage_.size();
+    for (auto &entry : chunks_) {
+      auto *chunk = entry.load(std::memory_order_acquire);
+      if (!chunk) break;
+      auto *slot = reinterpret_cast<const Slot *>(obj);
+      if (slot >= &chunk->slots[0] && slot < &chunk->slots[0] + chunk_size)
+        return true;
+    }
+    return false;
   }
 };
 
 }  // namespace rt
 }  // namespace nxs
 
-#endif  // RT_POOL_H
\ No newline at end of file
+#endif  // RT_POOL_H
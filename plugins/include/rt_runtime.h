@@ -2,6 +2,7 @@
 #define RT_RUNTIME_H
 
 #include <nexus-api.h>
+#include <rt_handle_table.h>
 #include <rt_object.h>
 #include <rt_pool.h>
 
@@ -11,7 +12,7 @@ namespace nxs {
 namespace rt {
 
 class Runtime {
-  Pool<rt::Object> objects;
+  HandleTable<rt::Object> objects;
 
 public:
  Runtime() {}
@@ -23,8 +24,8 @@ public:
   nxs_int addObject(nxs_long value) { return objects.acquire(value); }
 
   std::optional<rt::Object *> getObject(nxs_int id) {
-    if (id < 0 || id >= objects.capacity()) return std::nullopt;
-    return objects.get(id);
+    if (auto *obj = objects.get(id)) return obj;
+    return std::nullopt;
   }
 
   template <typename T = void>
@@ -38,11 +39,9 @@ public:
   }
 
   bool dropObject(nxs_int id, release_fn_t fn = nullptr) {
-    if (id < 0 || id >= objects.capacity()) return false;
-    auto obj = objects.get(id);
-    if (fn) fn(obj->get());
-    objects.release(id);
-    return true;
+    return objects.release(id, [&](rt::Object &obj) {
+      if (fn) fn(obj.get());
+    });
   }
 
   nxs_int getNumObjects() { return objects.get_in_use_count(); }
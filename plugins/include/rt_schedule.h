@@ -3,6 +3,9 @@
 
 #include <rt_command.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace nxs {
 namespace rt {
 
@@ -27,6 +30,13 @@ class Schedule {
 
   void addCommand(Tcommand *command) { commands.push_back(command); }
 
+  bool removeCommand(Tcommand *command) {
+    auto it = std::find(commands.begin(), commands.end(), command);
+    if (it == commands.end()) return false;
+    commands.erase(it);
+    return true;
+  }
+
   const Commands &getCommands() const { return commands; }
 
   virtual nxs_status run(Tstream stream, nxs_uint run_settings) = 0;
@@ -7,6 +7,7 @@
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace nxs {
 namespace rt {
@@ -83,6 +84,47 @@ static nxs_status getPropertyVec(void *property_value,
   return NXS_Success;
 }
 
+/// @brief Pack the values of keys for NP_Values; get(key, value, size) is
+/// the object's own property query. Keys it fails on are left out.
+template <typename Fn>
+static nxs_status getPropertyValues(void *property_value,
+                                    size_t *property_value_size,
+                                    const nxs_long *keys, size_t num_keys,
+                                    Fn &&get) {
+  constexpr size_t skip = ~size_t(0);
+  auto words = [](size_t bytes) { return (bytes + 7) / sizeof(nxs_long); };
+  std::vector<size_t> sizes(num_keys, 0);
+  size_t total = 0;
+  for (size_t i = 0; i < num_keys; ++i) {
+    if (!nxs_success(get(keys[i], nullptr, &sizes[i]))) {
+      sizes[i] = skip;
+      continue;
+    }
+    total += (2 + words(sizes[i])) * sizeof(nxs_long);
+  }
+  if (property_value != NULL) {
+    if (property_value_size == NULL)
+      return NXS_InvalidArgSize;
+    else if (*property_value_size < total)
+      return NXS_InvalidArgValue;
+    auto *record = static_cast<nxs_long *>(property_value);
+    for (size_t i = 0; i < num_keys; ++i) {
+      if (sizes[i] == skip) continue;
+      size_t size = sizes[i];
+      record[0] = keys[i];
+      record[1] = size;
+      if (size) record[words(size) + 1] = 0;
+      auto status = get(keys[i], record + 2, &size);
+      if (!nxs_success(status)) return status;
+      record += 2 + words(sizes[i]);
+    }
+  }
+  if (property_value_size != NULL) {
+    *property_value_size = total;
+  }
+  return NXS_Success;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //  Dump debug
 template <typename T>
@@ -271,43 +271,49 @@ static py::class_<Objects<T>> make_objects_class(py::module &m, const std::strin
       .def("size", [](Objects<T> &self) { return self.size(); });
 }
 
-static nxs_status set_argument(Command &self, int index, py::object value,
-                               const char *name = "", nxs_data_type data_type = NXS_DataType_Undefined,
-                               bool is_const = false) {
+static std::optional<CommandArg> make_command_arg(
+    py::object value, const char *name = "",
+    nxs_data_type data_type = NXS_DataType_Undefined, bool is_const = false) {
   // Argument conversion precedence:
   // Buffer -> tensor-like object -> bool -> int -> float -> None sentinel.
   nxs_uint settings = data_type | (is_const ? NXS_CommandArgType_Constant : 0);
   if (py::isinstance<Buffer>(value)) {
-    auto buf = value.cast<Buffer>();
-    return self.setArgument(index, buf, name, settings);
+    return CommandArg(value.cast<Buffer>(), name, settings);
   }
   else if (Buffer buffer = make_buffer(value)) {
-    return self.setArgument(index, buffer, name, settings);
+    return CommandArg(buffer, name, settings);
   }
   // Test for bool (check before int, since bool is subclass of int in Python)
   else if (py::isinstance<py::bool_>(value)) {
-    bool val = value.cast<bool>();
-    return self.setArgument(index, val, name, settings);
+    return CommandArg(value.cast<bool>(), name, settings);
   }
   // Test for int
   else if (py::isinstance<py::int_>(value)) {
-    nxs_int val = value.cast<nxs_int>();
     if (data_type == NXS_DataType_Undefined)
       settings |= NXS_DataType_I32;
-    return self.setArgument(index, val, name, settings);
+    return CommandArg(value.cast<nxs_int>(), name, settings);
   }
   // Test for float
   else if (py::isinstance<py::float_>(value)) {
-    nxs_float val = value.cast<nxs_float>();
     if (data_type == NXS_DataType_Undefined)
       settings |= NXS_DataType_F32;
-    return self.setArgument(index, val, name, settings);
+    return CommandArg(value.cast<nxs_float>(), name, settings);
   }
   else if (value.is_none()) {
     auto none_buf = nexus::getSystem().createBuffer(0, nullptr, NXS_BufferSettings_OnDevice);
-    return self.setArgument(index, none_buf, name, settings);
+    return CommandArg(none_buf, name, settings);
   }
-  return NXS_InvalidArgValue;
+  return std::nullopt;
+}
+
+static nxs_status set_argument(Command &self, int index, py::object value,
+                               const char *name = "", nxs_data_type data_type = NXS_DataType_Undefined,
+                               bool is_const = false) {
+  auto arg = make_command_arg(value, name, data_type, is_const);
+  if (!arg) return NXS_InvalidArgValue;
+  return std::visit(
+      [&](auto val) { return self.setArgument(index, val, name, arg->settings); },
+      arg->value);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -461,6 +467,14 @@ void pynexus::init_system_bindings(py::module &m) {
     .def_property_readonly("nbytes", [](Buffer &self) { return self.getSizeBytes(); })
     .def_property_readonly("dtype", [](Buffer &self) { return self.getLayout().getDataType(); })
     .def("data_ptr", [](Buffer &self) -> intptr_t { return reinterpret_cast<intptr_t>(self.getDataPtr()); })
+    .def("view", [](Buffer &self, nxs_ulong offset, std::vector<nxs_ulong> shape,
+                    std::vector<nxs_ulong> strides, nxs_data_type data_type) {
+      return self.createView(offset, Layout(shape, strides, data_type));
+    }, py::arg("offset"), py::arg("shape"), py::arg("strides") = std::vector<nxs_ulong>(),
+       py::arg("data_type") = NXS_DataType_Undefined,
+       "Zero-copy view `offset` bytes into this buffer with its own shape and element strides; keeps this buffer alive.")
+    .def("parent", [](Buffer &self) { return self.getParentBuffer(); }, "Return the buffer this one is a view of.")
+    .def_property_readonly("offset", [](Buffer &self) { return self.getOffset(); })
     .def("copy", [](Buffer &self, py::object tensor) {
       auto data_ptr = getPointer(tensor.ptr());
       if (!data_ptr.runtime_name.empty() && data_ptr.runtime_name != "cpu") {
@@ -519,6 +533,11 @@ void pynexus::init_system_bindings(py::module &m) {
           "create_command",
           [](Schedule &self, Kernel kernel, std::vector<Buffer> buffers,
              std::vector<nxs_dim3> dims) {
+            // Arguments and dims in one runtime call
+            if (dims.size() == 2 && dims[0].x > 0 && dims[1].x > 0)
+              return self.createCommand(
+                  kernel, CommandArgs(buffers.begin(), buffers.end()),
+                  dims[0], dims[1]);
             auto cmd = self.createCommand(kernel);
             if (cmd) {
               int idx = 0;
@@ -537,6 +556,15 @@ void pynexus::init_system_bindings(py::module &m) {
           "create_command",
           [](Schedule &self, Kernel kernel, std::vector<py::object> buffers,
              std::vector<nxs_dim3> dims) {
+            if (dims.size() == 2 && dims[0].x > 0 && dims[1].x > 0) {
+              CommandArgs args;
+              for (auto &value : buffers) {
+                auto arg = make_command_arg(value);
+                if (!arg) return Command();
+                args.push_back(*arg);
+              }
+              return self.createCommand(kernel, args, dims[0], dims[1]);
+            }
             auto cmd = self.createCommand(kernel);
             if (cmd) {
               int idx = 0;
@@ -3,11 +3,14 @@
 
 #include <nexus/device.h>
 
+#include "_property_cache.h"
+
 namespace nexus {
 namespace detail {
 class BufferImpl : public Impl {
  public:
   BufferImpl(Impl base, const Layout &layout, const char *_hostData);
+  BufferImpl(Impl base, const Layout &layout, Buffer parent, nxs_ulong offset);
 
   ~BufferImpl();
 
@@ -22,8 +25,16 @@ class BufferImpl : public Impl {
   void setData(nxs_ulong sz, const char *hostData);
   void setData(void *_data) { data = _data; }
 
+  Buffer createView(Buffer self, nxs_ulong offset, const Layout &layout,
+                    nxs_uint settings);
+  Buffer getParentBuffer() const { return parent; }
+  nxs_ulong getOffset() const { return offset; }
+
   Buffer getLocal();
   nxs_status copyData(void *_hostBuf, nxs_uint direction) const;
+  nxs_status copyRegion(void *_hostBuf, const nxs_buffer_region &region,
+                        nxs_uint direction) const;
+  nxs_status copyRegion(Buffer dst, const nxs_buffer_region &region) const;
   nxs_status fillData(void *value, nxs_uint size_bytes) const;
   std::string print() const;
 
@@ -36,6 +47,10 @@ class BufferImpl : public Impl {
   nxs_ulong size_bytes;
   Layout layout;
   void *data;
+  // a view holds on to the buffer it looks into
+  Buffer parent;
+  nxs_ulong offset = 0;
+  PropertyCache properties;
 };
 }  // namespace detail
 }  // namespace nexus
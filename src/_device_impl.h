@@ -15,6 +15,7 @@ namespace detail {
 /// @class DesignImpl
 class DeviceImpl : public Impl {
   Info deviceInfo;
+  PropertyCache properties;
   Buffers buffers;
   Librarys libraries;
   Schedules schedules;
@@ -52,6 +53,8 @@ class DeviceImpl : public Impl {
   Buffer createBuffer(const Layout &layout, const void *data = nullptr,
                       nxs_uint settings = 0);
   Buffer copyBuffer(Buffer buf, nxs_uint settings = 0);
+  Buffer createSubBuffer(Buffer parent, nxs_ulong offset, const Layout &layout,
+                         nxs_uint settings = 0);
   Buffer fillBuffer(void *value, nxs_uint value_size_bytes);
 };
 
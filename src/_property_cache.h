@@ -0,0 +1,67 @@
+#ifndef _NEXUS_PROPERTY_CACHE_H
+#define _NEXUS_PROPERTY_CACHE_H
+
+#include <nexus/property.h>
+
+#include <utility>
+#include <vector>
+
+namespace nexus {
+namespace detail {
+
+/// @class PropertyCache
+/// Properties of an object that cannot change after it is created (names,
+/// sizes, the data pointer of a buffer). Filled once at creation, so later
+/// queries of them skip the plugin.
+class PropertyCache {
+  std::vector<std::pair<nxs_int, Property>> values;
+
+ public:
+  static bool isImmutable(nxs_int prop) {
+    switch (prop) {
+      case NP_Name:
+      case NP_Type:
+      case NP_Vendor:
+      case NP_Architecture:
+      case NP_Version:
+      case NP_MajorVersion:
+      case NP_MinorVersion:
+      case NP_ID:
+      case NP_Size:
+      case NP_Value:
+      case NP_Shape:
+      case NP_GlobalMemorySize:
+      case NP_Alignment:
+      case NP_PageSize:
+      case NP_Placement:
+      case NP_Offset:
+        return true;
+    }
+    return false;
+  }
+
+  /// @brief Keep value if prop is immutable.
+  void set(nxs_int prop, Property value) {
+    if (!isImmutable(prop)) return;
+    for (auto &entry : values) {
+      if (entry.first == prop) {
+        entry.second = std::move(value);
+        return;
+      }
+    }
+    values.emplace_back(prop, std::move(value));
+  }
+
+  const Property *find(nxs_int prop) const {
+    for (auto &entry : values)
+      if (entry.first == prop) return &entry.second;
+    return nullptr;
+  }
+
+  void clear() { values.clear(); }
+};
+
+}  // namespace detail
+}  // namespace nexus
+
+#endif  // _NEXUS_PROPERTY_CACHE_H
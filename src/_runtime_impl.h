@@ -5,11 +5,14 @@
 #include <nexus/device.h>
 
 #include <cstring>
+#include <initializer_list>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "_property_cache.h"
+
 #define NEXUS_LOG_MODULE "runtime"
 
 namespace nexus {
@@ -112,12 +115,74 @@ class RuntimeImpl : public Impl {
     return std::nullopt;
   }
 
+  /// @brief Fill cache with the immutable properties of an object, all
+  /// from one NP_Values query; plugins that do not pack their values are
+  /// asked for the fallback properties one at a time.
+  template <nxs_function Tfn, typename... Args>
+  void cacheAPIProperties(PropertyCache &cache,
+                          std::initializer_list<nxs_int> fallback,
+                          Args... args) const {
+    auto *fn = getFunction<Tfn>();
+    if (!fn) return;
+    nxs_long packed[128];
+    std::vector<nxs_long> large;
+    nxs_long *data = packed;
+    size_t size = sizeof(packed);
+    auto status = (*fn)(args..., NP_Values, data, &size);
+    if (status == NXS_InvalidArgValue &&
+        nxs_success((*fn)(args..., NP_Values, nullptr, &size))) {
+      large.resize(size / sizeof(nxs_long));
+      data = large.data();
+      status = (*fn)(args..., NP_Values, data, &size);
+    }
+    if (!nxs_success(status)) {
+      for (auto prop : fallback)
+        if (auto value = getAPIProperty<Tfn>(prop, args...))
+          cache.set(prop, *value);
+      return;
+    }
+    NEXUS_LOG(NXS_LOG_NOTE, nxsGetFuncName(Tfn), ": Values = ", size,
+              " bytes");
+
+    // Records of key, size in bytes and the value padded to whole words
+    const size_t count = size / sizeof(nxs_long);
+    for (size_t pos = 0; pos + 2 <= count;) {
+      nxs_long prop = data[pos];
+      size_t bytes = data[pos + 1];
+      const nxs_long *value = data + pos + 2;
+      pos += 2 + (bytes + sizeof(nxs_long) - 1) / sizeof(nxs_long);
+      if (pos > count || prop < 0 || prop >= NXS_PROPERTY_CNT) break;
+      switch (nxs_property_type_map[prop]) {
+        case NPT_INT:
+          if (bytes == sizeof(nxs_long)) cache.set(prop, Property(*value));
+          break;
+        case NPT_FLT:
+          if (bytes == sizeof(nxs_double))
+            cache.set(prop,
+                      Property(*reinterpret_cast<const nxs_double *>(value)));
+          break;
+        case NPT_STR: {
+          auto *str = reinterpret_cast<const char *>(value);
+          cache.set(prop, Property(std::string(str, strnlen(str, bytes))));
+          break;
+        }
+        case NPT_INT_VEC:
+          cache.set(prop, Property(PropIntVec(
+                              value, value + bytes / sizeof(nxs_long))));
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
  private:
   void loadPlugin();
 
   std::string pluginLibraryPath;
   void *library;
   void *runtimeFns[NXS_FUNCTION_CNT];
+  PropertyCache properties;
 
   Objects<Device> devices;
 };
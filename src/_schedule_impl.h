@@ -18,6 +18,9 @@ class ScheduleImpl : public Impl {
   std::optional<Property> getProperty(nxs_int prop) const;
 
   Command createCommand(Kernel kern, nxs_uint settings);
+  Command createCommand(Kernel kern, const CommandArgs &args,
+                        nxs_dim3 gridSize, nxs_dim3 groupSize,
+                        nxs_uint sharedMemorySize, nxs_uint settings);
   Command createCommand(Event event, nxs_uint settings);
   Command createSignalCommand(nxs_int signal_value, nxs_uint settings);
   Command createSignalCommand(Event event, nxs_int signal_value,
@@ -4,6 +4,7 @@
 #include <nexus/system.h>
 
 #include <cstring>
+#include <vector>
 
 #include "_buffer_impl.h"
 #include "_device_impl.h"
@@ -22,13 +23,31 @@ detail::BufferImpl::BufferImpl(detail::Impl base, const Layout &layout, const ch
     size_bytes /= 8;
   }
   setData(size_bytes, _hostData);
+  if (getParentOfType<DeviceImpl>() && nxs_valid_id(getId())) {
+    auto *rt = getParentOfType<RuntimeImpl>();
+    rt->cacheAPIProperties<NF_nxsGetBufferProperty>(properties, {NP_Value},
+                                                    getId());
+  }
+}
+
+detail::BufferImpl::BufferImpl(detail::Impl base, const Layout &layout,
+                               Buffer parent, nxs_ulong offset)
+    : BufferImpl(base, layout, nullptr) {
+  this->parent = parent;
+  this->offset = offset;
 }
 
 detail::BufferImpl::~BufferImpl() { release(); }
 
 void detail::BufferImpl::release() {
+  if (getParentOfType<DeviceImpl>() && nxs_valid_id(getId())) {
+    auto *rt = getParentOfType<RuntimeImpl>();
+    rt->runAPIFunction<NF_nxsReleaseBuffer>(getId());
+  }
   size_bytes = 0;
   data = nullptr;
+  parent = Buffer();
+  properties.clear();
 }
 
 void *detail::BufferImpl::getVoidData() const {
@@ -36,6 +55,8 @@ void *detail::BufferImpl::getVoidData() const {
 }
 
 const char *detail::BufferImpl::getDataPtr() const {
+  if (auto *value = properties.find(NP_Value))
+    return reinterpret_cast<const char *>(value->getValue<nxs_long>());
   auto rt = getParentOfType<RuntimeImpl>();
   if (rt) {
     if (auto property = rt->getAPIProperty<NF_nxsGetBufferProperty>(NP_Value, getId())) {
@@ -58,6 +79,7 @@ std::optional<Property> detail::BufferImpl::getProperty(nxs_int prop) const {
       return Property(dims);
     }
   }
+  if (auto *value = properties.find(prop)) return *value;
   if (getParentOfType<DeviceImpl>()) {
     auto *rt = getParentOfType<RuntimeImpl>();
     return rt->getAPIProperty<NF_nxsGetBufferProperty>(prop, getId());
@@ -80,6 +102,162 @@ nxs_status detail::BufferImpl::copyData(void *_hostBuf, nxs_uint direction) cons
   return NXS_InvalidDevice;
 }
 
+namespace {
+
+// Bytes a region reaches past its src (or dst) offset
+nxs_ulong getRegionSpan(const nxs_buffer_region &region, bool src) {
+  nxs_ulong span = region.extent[0];
+  for (nxs_uint d = 1; d < region.rank; ++d)
+    span += (region.extent[d] - 1) *
+            (src ? region.src_stride[d] : region.dst_stride[d]);
+  return span;
+}
+
+// True if the elements are packed in dim 0 order; all-zero strides (the
+// legacy default) count as packed
+bool isPacked(const Layout &layout) {
+  bool strided = false;
+  for (nxs_uint d = 0; d < layout.getRank(); ++d)
+    strided |= layout.getStride(d) != 0;
+  if (!strided) return true;
+  nxs_ulong expected = 1;
+  for (nxs_uint d = 0; d < layout.getRank(); ++d) {
+    if (layout.getDim(d) <= 1) continue;
+    if (layout.getStride(d) != expected) return false;
+    expected *= layout.getDim(d);
+  }
+  return true;
+}
+
+// Bytes from the first to one past the last element, which bound region
+// offsets like nxsCopyBufferRegion does; more than the packed size of a
+// strided view
+nxs_ulong getExtentBytes(const Layout &layout, nxs_ulong size_bytes) {
+  if (isPacked(layout)) return size_bytes;
+  nxs_ulong last = 0;
+  for (nxs_uint d = 0; d < layout.getRank(); ++d) {
+    if (layout.getDim(d) == 0) return 0;
+    last += (layout.getDim(d) - 1) * layout.getStride(d);
+  }
+  return (last + 1) * layout.getElementSizeBits() / 8;
+}
+
+// Copy the first `bytes` raw bytes of a buffer to or from the host. A view
+// that is not packed is copied through a temporary byte view of the same
+// memory, as nxsCopyBuffer would gather its elements instead.
+nxs_status copyRawBytes(detail::RuntimeImpl *rt, nxs_int buffer_id,
+                        const Layout &layout, Buffer parent, nxs_ulong offset,
+                        void *host, nxs_ulong bytes, nxs_uint direction) {
+  if (isPacked(layout))
+    return (nxs_status)rt->runAPIFunction<NF_nxsCopyBuffer>(buffer_id, host,
+                                                            direction);
+  if (!parent) return NXS_InvalidBufferSize;
+  nxs_buffer_layout raw{NXS_DataType_U8, 1, {bytes}, {1}};
+  nxs_int raw_id = rt->runAPIFunction<NF_nxsCreateSubBuffer>(
+      parent.getId(), offset, raw, 0);
+  if (!nxs_valid_id(raw_id)) return (nxs_status)raw_id;
+  auto status = rt->runAPIFunction<NF_nxsCopyBuffer>(raw_id, host, direction);
+  rt->runAPIFunction<NF_nxsReleaseBuffer>(raw_id);
+  return (nxs_status)status;
+}
+
+bool isEmptyRegion(const nxs_buffer_region &region) {
+  for (nxs_uint d = 0; d < region.rank; ++d)
+    if (region.extent[d] == 0) return true;
+  return false;
+}
+
+// Region copy between host ranges, for runtimes without CopyBufferRegion
+void copyHostRegion(char *dst, const char *src,
+                    const nxs_buffer_region &region) {
+  nxs_ulong rows = 1;
+  for (nxs_uint d = 1; d < region.rank; ++d) rows *= region.extent[d];
+  for (nxs_ulong r = 0; r < rows; ++r) {
+    nxs_ulong src_pos = region.src_offset, dst_pos = region.dst_offset;
+    nxs_ulong rest = r;
+    for (nxs_uint d = 1; d < region.rank; ++d) {
+      nxs_ulong index = rest % region.extent[d];
+      rest /= region.extent[d];
+      src_pos += index * region.src_stride[d];
+      dst_pos += index * region.dst_stride[d];
+    }
+    std::memmove(dst + dst_pos, src + src_pos, region.extent[0]);
+  }
+}
+
+}  // namespace
+
+nxs_status detail::BufferImpl::copyRegion(void *_hostBuf,
+                                          const nxs_buffer_region &region,
+                                          nxs_uint direction) const {
+  auto *rt = getParentOfType<RuntimeImpl>();
+  if (!getParentOfType<DeviceImpl>() || !rt) return NXS_InvalidDevice;
+  if (region.rank == 0 || region.rank > NXS_MAX_DIMS) return NXS_InvalidValue;
+  bool to_device = direction == NXS_BufferHostToDevice;
+  NEXUS_LOG(NXS_LOG_NOTE, "copyRegion: ", to_device ? "to" : "from",
+            " device");
+  if (rt->getFunction<NF_nxsCopyBufferRegion>())
+    return (nxs_status)rt->runAPIFunction<NF_nxsCopyBufferRegion>(
+        to_device ? NXS_InvalidBuffer : getId(),
+        to_device ? getId() : NXS_InvalidBuffer, _hostBuf, &region, 0);
+
+  // stage the raw bytes of the buffer through the host
+  if (isEmptyRegion(region)) return NXS_Success;
+  nxs_ulong extent = getExtentBytes(layout, getSizeBytes());
+  nxs_ulong region_offset = to_device ? region.dst_offset : region.src_offset;
+  if (region_offset + getRegionSpan(region, !to_device) > extent)
+    return NXS_InvalidBufferSize;
+  std::vector<char> staging(extent);
+  auto status = copyRawBytes(rt, getId(), layout, parent, offset,
+                             staging.data(), extent, NXS_BufferDeviceToHost);
+  if (!nxs_success(status)) return status;
+  if (!to_device) {
+    copyHostRegion((char *)_hostBuf, staging.data(), region);
+    return NXS_Success;
+  }
+  copyHostRegion(staging.data(), (const char *)_hostBuf, region);
+  return copyRawBytes(rt, getId(), layout, parent, offset, staging.data(),
+                      extent, NXS_BufferHostToDevice);
+}
+
+nxs_status detail::BufferImpl::copyRegion(Buffer dst,
+                                          const nxs_buffer_region &region) const {
+  auto *rt = getParentOfType<RuntimeImpl>();
+  if (!getParentOfType<DeviceImpl>() || !rt || !dst) return NXS_InvalidDevice;
+  if (region.rank == 0 || region.rank > NXS_MAX_DIMS) return NXS_InvalidValue;
+  NEXUS_LOG(NXS_LOG_NOTE, "copyRegion: buffer ", getId(), " -> ", dst.getId());
+  // buffers of the same runtime copy on the device
+  if (dst.getParentOfType<RuntimeImpl>() == rt &&
+      rt->getFunction<NF_nxsCopyBufferRegion>())
+    return (nxs_status)rt->runAPIFunction<NF_nxsCopyBufferRegion>(
+        getId(), dst.getId(), nullptr, &region, 0);
+
+  // otherwise stage the raw bytes of both through the host
+  if (isEmptyRegion(region)) return NXS_Success;
+  // the facade only hands out const parents
+  auto *dst_rt = const_cast<RuntimeImpl *>(dst.getParentOfType<RuntimeImpl>());
+  if (!dst_rt) return NXS_InvalidDevice;
+  nxs_ulong src_extent = getExtentBytes(layout, getSizeBytes());
+  nxs_ulong dst_extent = getExtentBytes(dst.getLayout(), dst.getSizeBytes());
+  if (region.src_offset + getRegionSpan(region, true) > src_extent ||
+      region.dst_offset + getRegionSpan(region, false) > dst_extent)
+    return NXS_InvalidBufferSize;
+  std::vector<char> src_staging(src_extent);
+  std::vector<char> dst_staging(dst_extent);
+  auto status = copyRawBytes(rt, getId(), layout, parent, offset,
+                             src_staging.data(), src_extent,
+                             NXS_BufferDeviceToHost);
+  if (!nxs_success(status)) return status;
+  status = copyRawBytes(dst_rt, dst.getId(), dst.getLayout(),
+                        dst.getParentBuffer(), dst.getOffset(),
+                        dst_staging.data(), dst_extent, NXS_BufferDeviceToHost);
+  if (!nxs_success(status)) return status;
+  copyHostRegion(dst_staging.data(), src_staging.data(), region);
+  return copyRawBytes(dst_rt, dst.getId(), dst.getLayout(),
+                      dst.getParentBuffer(), dst.getOffset(),
+                      dst_staging.data(), dst_extent, NXS_BufferHostToDevice);
+}
+
 nxs_status detail::BufferImpl::fillData(void *value, nxs_uint size_bytes) const {
   nxs_status return_stat;
   if (getParentOfType<DeviceImpl>()) {
@@ -91,6 +269,15 @@ nxs_status detail::BufferImpl::fillData(void *value, nxs_uint size_bytes) const
   return return_stat;
 }
 
+Buffer detail::BufferImpl::createView(Buffer self, nxs_ulong offset,
+                                      const Layout &layout,
+                                      nxs_uint settings) {
+  if (auto *dev = getParentOfType<DeviceImpl>())
+    return dev->createSubBuffer(self, offset, layout, settings);
+  NEXUS_LOG(NXS_LOG_ERROR, "createView: buffer is not on a device");
+  return Buffer();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 Buffer::Buffer(detail::Impl base, const Layout &layout, const void *_hostData)
     : Object(base, layout, (const char *)_hostData) {}
@@ -108,9 +295,35 @@ const char *Buffer::getDataPtr() const { NEXUS_OBJ_MCALL(nullptr, getDataPtr); }
 nxs_status Buffer::copy(void *_hostBuf, nxs_uint direction) {
   NEXUS_OBJ_MCALL(NXS_InvalidBuffer, copyData, _hostBuf, direction);
 }
+nxs_status Buffer::copy(void *_hostBuf, nxs_ulong offset, nxs_ulong size,
+                        nxs_uint direction) {
+  nxs_buffer_region region{};
+  region.rank = 1;
+  region.extent[0] = size;
+  if (direction == NXS_BufferHostToDevice)
+    region.dst_offset = offset;
+  else
+    region.src_offset = offset;
+  return copyRegion(_hostBuf, region, direction);
+}
+nxs_status Buffer::copyRegion(void *_hostBuf, const nxs_buffer_region &region,
+                              nxs_uint direction) {
+  NEXUS_OBJ_MCALL(NXS_InvalidBuffer, copyRegion, _hostBuf, region, direction);
+}
+nxs_status Buffer::copyRegion(Buffer dst, const nxs_buffer_region &region) {
+  NEXUS_OBJ_MCALL(NXS_InvalidBuffer, copyRegion, dst, region);
+}
 nxs_status Buffer::fill(void *value, nxs_uint size_bytes) {
   NEXUS_OBJ_MCALL(NXS_InvalidBuffer, fillData, value, size_bytes);
 }
+Buffer Buffer::createView(nxs_ulong offset, const Layout &layout,
+                          nxs_uint settings) {
+  NEXUS_OBJ_MCALL(Buffer(), createView, *this, offset, layout, settings);
+}
+Buffer Buffer::getParentBuffer() const {
+  NEXUS_OBJ_MCALL(Buffer(), getParentBuffer);
+}
+nxs_ulong Buffer::getOffset() const { NEXUS_OBJ_MCALL(0, getOffset); }
 
 ////////////////////////////////////////////////////////////////////////////////
 // This constructor is used to construct a layout from a shape and data type.
@@ -2,6 +2,7 @@
 #include <nexus/command.h>
 #include <nexus/log.h>
 
+#include "_info_impl.h"
 #include "_schedule_impl.h"
 
 #define NEXUS_LOG_MODULE "command"
@@ -11,9 +12,7 @@ using namespace nexus;
 namespace nexus {
 namespace detail {
 class CommandImpl : public Impl {
-  typedef std::variant<Buffer, nxs_int, nxs_uint, nxs_long, nxs_ulong,
-                       nxs_float, nxs_double, nxs_short, nxs_ushort, nxs_char, nxs_uchar, bool>
-      Arg;
+  typedef CommandArg::Value Arg;
 
   struct ArgValue {
     Arg value;
@@ -24,13 +23,83 @@ class CommandImpl : public Impl {
   /// @brief Construct a Platform for the current system
   CommandImpl(Impl owner, Kernel kern) : Impl(owner), kernel(kern) {
     NEXUS_LOG(NXS_LOG_NOTE, "    Command: ", getId());
-    // TODO: gather kernel argument details
+    loadCatalogAccess();
   }
 
   CommandImpl(Impl owner, Event event) : Impl(owner), event(event) {
     NEXUS_LOG(NXS_LOG_NOTE, "    Command: ", getId());
   }
 
+  /// @brief Create the command on the schedule that owns `owner`, with
+  /// all arguments and launch dims in one plugin call when the runtime
+  /// has nxsCreateDispatch, or one call per step otherwise.
+  CommandImpl(Impl owner, Kernel kern, const CommandArgs &args,
+              nxs_dim3 gridSize, nxs_dim3 groupSize,
+              nxs_uint sharedMemorySize)
+      : Impl(owner), kernel(kern) {
+    loadCatalogAccess();
+    auto *rt = getParentOfType<RuntimeImpl>();
+    nxs_int schedule_id = getParent()->getId();
+    if (args.size() > NXS_KERNEL_MAX_ARGS) {
+      setId(NXS_InvalidArgIndex);
+      return;
+    }
+    if (!rt->getFunction<NF_nxsCreateDispatch>()) {
+      setId(rt->runAPIFunction<NF_nxsCreateCommand>(
+          schedule_id, kernel.getId(), getSettings()));
+      if (!nxs_valid_id(getId())) return;
+      nxs_status status = NXS_Success;
+      for (nxs_uint i = 0; i < args.size() && nxs_success(status); ++i)
+        status = std::visit(
+            [&](auto value) {
+              return setArgument(i, value, args[i].name, args[i].settings);
+            },
+            args[i].value);
+      if (nxs_success(status))
+        status = finalize(gridSize, groupSize, sharedMemorySize);
+      if (!nxs_success(status)) {
+        // like nxsCreateDispatch, leave nothing in the schedule
+        if (rt->getFunction<NF_nxsReleaseCommand>())
+          rt->runAPIFunction<NF_nxsReleaseCommand>(schedule_id, getId());
+        setId(status);
+        return;
+      }
+      NEXUS_LOG(NXS_LOG_NOTE, "    Command: ", getId());
+      return;
+    }
+
+    std::vector<nxs_command_arg> descs(args.size());
+    for (nxs_uint i = 0; i < args.size(); ++i) {
+      auto &desc = descs[i];
+      desc.settings = args[i].settings;
+      if (auto *buffer = std::get_if<Buffer>(&args[i].value)) {
+        auto &buf = *putArgument(i, bindBuffer(*buffer), args[i].name);
+        desc.buffer_id = buf.getId();
+        desc.value = nullptr;
+        if (!(desc.settings & NXS_CommandArgAccess_Mask))
+          desc.settings |= catalog_access[i];
+        desc.name = arguments[i].name.c_str();
+        continue;
+      }
+      desc.buffer_id = NXS_InvalidBuffer;
+      bool constant = desc.settings & NXS_CommandArgType_Constant;
+      std::visit(
+          [&](auto value) {
+            if constexpr (!std::is_same_v<decltype(value), Buffer>) {
+              desc.value = constant ? (void *)putConstant(i, value, args[i].name)
+                                    : (void *)putArgument(i, value, args[i].name);
+            }
+          },
+          args[i].value);
+      desc.name = constant ? constants[i].name.c_str()
+                           : arguments[i].name.c_str();
+    }
+    setId(rt->runAPIFunction<NF_nxsCreateDispatch>(
+        schedule_id, kernel.getId(), descs.data(), (nxs_uint)descs.size(),
+        gridSize, groupSize, sharedMemorySize, getSettings()));
+    NEXUS_LOG(NXS_LOG_NOTE, "    Command: ", getId());
+  }
+
   ~CommandImpl() {
     NEXUS_LOG(NXS_LOG_NOTE, "    ~Command: ", getId());
     release();
@@ -62,14 +131,17 @@ class CommandImpl : public Impl {
         getId(), index, val_ptr, name_ptr, settings);
   }
 
+  template <typename T>
+  nxs_status setArgument(nxs_uint index, T value, const char *name, nxs_uint settings) {
+    return setScalar(index, value, name, settings);
+  }
+
   nxs_status setArgument(nxs_uint index, Buffer buffer, const char *name, nxs_uint settings) {
     if (event) return NXS_InvalidArgIndex;
-    auto *dev = getParentOfType<DeviceImpl>();
-    auto *buf_dev = buffer.getParentOfType<DeviceImpl>();
-    if (buf_dev && buf_dev != dev) {
-      buffer = dev->copyBuffer(buffer);
-    }
+    buffer = bindBuffer(buffer);
     putArgument(index, buffer, name);
+    if (!(settings & NXS_CommandArgAccess_Mask) && index < catalog_access.size())
+      settings |= catalog_access[index];
     auto *rt = getParentOfType<RuntimeImpl>();
     return (nxs_status)rt->runAPIFunction<NF_nxsSetCommandArgument>(
         getId(), index, buffer.getId(), arguments[index].name.c_str(), settings);
@@ -86,6 +158,34 @@ class CommandImpl : public Impl {
   Kernel kernel;
   Event event;
 
+  // Buffers of another device are copied to the command's device
+  Buffer bindBuffer(Buffer buffer) {
+    auto *dev = getParentOfType<DeviceImpl>();
+    auto *buf_dev = buffer.getParentOfType<DeviceImpl>();
+    if (buf_dev && buf_dev != dev) return dev->copyBuffer(buffer);
+    return buffer;
+  }
+
+  // Catalog metadata records whether a pointer parameter points at const
+  // data; such a buffer is only read by the kernel. `T *const` says nothing
+  // about the data, so only PointeeConst counts. Resolved once so binding
+  // stays cheap. A packed kernel's parameters are its two frame pointers,
+  // not the user's arguments, so they say nothing about access.
+  void loadCatalogAccess() {
+    auto info = kernel.getInfo().getNode({});
+    if (!info) return;
+    try {
+      if (info->get<bool>("PackedArgs")) return;
+      auto &params = info->at("Parameters");
+      for (size_t index = 0;
+           index < params.size() && index < catalog_access.size(); ++index) {
+        if (params[index].value("PointeeConst", false))
+          catalog_access[index] = NXS_CommandArgAccess_Read;
+      }
+    } catch (...) {
+    }
+  }
+
   template <typename T>
   T *putArgument(nxs_uint index, T value, const char *name) {
     if (index >= arguments.size())
@@ -104,6 +204,7 @@ class CommandImpl : public Impl {
 
   std::array<ArgValue, NXS_KERNEL_MAX_ARGS> arguments;
   std::array<ArgValue, NXS_KERNEL_MAX_CONSTS> constants;
+  std::array<nxs_uint, NXS_KERNEL_MAX_ARGS> catalog_access{};
 };
 }  // namespace detail
 }  // namespace nexus
@@ -113,6 +214,12 @@ Command::Command(detail::Impl base, Kernel kern) : Object(base, kern) {}
 
 Command::Command(detail::Impl base, Event event) : Object(base, event) {}
 
+Command::Command(detail::Impl base, Kernel kern, const CommandArgs &args,
+                 nxs_dim3 gridSize, nxs_dim3 groupSize,
+                 nxs_uint sharedMemorySize)
+    : Object(base, kern, std::cref(args), gridSize, groupSize,
+             sharedMemorySize) {}
+
 std::optional<Property> Command::getProperty(nxs_int prop) const {
   NEXUS_OBJ_MCALL(std::nullopt, getProperty, prop);
 }
@@ -19,6 +19,9 @@ using namespace nexus;
   nxs_int apiResult = getParent()->runAPIFunction<NF_##FUNC>(__VA_ARGS__)
 
 detail::DeviceImpl::DeviceImpl(detail::Impl base) : detail::Impl(base) {
+  setOwnedDevice(this);
+  getParent()->cacheAPIProperties<NF_nxsGetDeviceProperty>(
+      properties, {NP_Name, NP_Vendor, NP_Type, NP_Architecture}, getId());
   auto vendor = getProperty(NP_Vendor);
   auto type = getProperty(NP_Type);
   auto arch = getProperty(NP_Architecture);
@@ -50,6 +53,7 @@ void detail::DeviceImpl::release() {
 }
 
 std::optional<Property> detail::DeviceImpl::getProperty(nxs_int prop) const {
+  if (auto *value = properties.find(prop)) return *value;
   auto *rt = getParentOfType<RuntimeImpl>();
   return rt->getAPIProperty<NF_nxsGetDeviceProperty>(prop, getId());
 }
@@ -165,9 +169,7 @@ Buffer detail::DeviceImpl::createBuffer(const Layout &layout, const void *data,
       normalized_layout.setDataType(data_type);
     }
   }
-  nxs_uint buffer_settings =
-      settings & (NXS_BufferSettings_OnHost | NXS_BufferSettings_OnDevice |
-                  NXS_BufferSettings_Maintain);
+  nxs_uint buffer_settings = settings & NXS_BufferSettings_Mask;
   APICALL(nxsCreateBuffer, getId(), normalized_layout.get(), (void *)data,
           buffer_settings);
   Buffer nbuf(Impl(this, apiResult, buffer_settings), normalized_layout, data);
@@ -177,7 +179,9 @@ Buffer detail::DeviceImpl::createBuffer(const Layout &layout, const void *data,
 
 Buffer detail::DeviceImpl::copyBuffer(Buffer buf, nxs_uint settings) {
   NEXUS_LOG(NXS_LOG_NOTE, "  copyBuffer");
-  settings |= buf.getSettings() & ~NXS_BufferSettings_OnDevice;
+  // a copy never aliases the source buffer
+  settings |= buf.getSettings() &
+              ~(NXS_BufferSettings_OnDevice | NXS_BufferSettings_ZeroCopy);
   auto *data_ptr = buf.getDataPtr();
   APICALL(nxsCreateBuffer, getId(), buf.getLayout().get(), (void *)data_ptr,
           settings);
@@ -186,6 +190,23 @@ Buffer detail::DeviceImpl::copyBuffer(Buffer buf, nxs_uint settings) {
   return nbuf;
 }
 
+Buffer detail::DeviceImpl::createSubBuffer(Buffer parent, nxs_ulong offset,
+                                           const Layout &layout,
+                                           nxs_uint settings) {
+  NEXUS_LOG(NXS_LOG_NOTE, "  createSubBuffer");
+  Layout normalized_layout = layout;
+  if (normalized_layout.getDataType() == NXS_DataType_Undefined)
+    normalized_layout.setDataType(parent.getLayout().getDataType());
+  nxs_uint buffer_settings = settings & NXS_BufferSettings_Mask;
+  APICALL(nxsCreateSubBuffer, parent.getId(), offset, normalized_layout.get(),
+          buffer_settings);
+  if (nxs_failed(apiResult)) return Buffer();
+  Buffer nbuf(Impl(this, apiResult, buffer_settings), normalized_layout,
+              parent, offset);
+  buffers.add(nbuf);
+  return nbuf;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Object wrapper - Device
 ///////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,9 @@
 #include <nexus/log.h>
 #include <nexus/runtime.h>
 
+#include <cstdlib>
+#include <string>
+
 #include "_runtime_impl.h"
 
 using namespace nexus;
@@ -14,6 +17,7 @@ using namespace nexus::detail;
 /// @brief Construct a Runtime for the current system
 RuntimeImpl::RuntimeImpl(Impl base, const std::string &path)
     : Impl(base), pluginLibraryPath(path), library(nullptr) {
+  setOwnedRuntime(this);
   NEXUS_LOG(NXS_LOG_NOTE, "  CTOR: ", path);
   loadPlugin();
 }
@@ -34,6 +38,7 @@ Device RuntimeImpl::getDevice(nxs_int deviceId) const {
 }
 
 std::optional<Property> detail::RuntimeImpl::getProperty(nxs_int prop) const {
+  if (auto *value = properties.find(prop)) return *value;
   return getAPIProperty<NF_nxsGetRuntimeProperty>(prop);
 }
 
@@ -53,8 +58,18 @@ void RuntimeImpl::loadPlugin() {
     return;
   }
 
+  // NEXUS_DISABLE_FUNCTIONS: comma separated entry points to leave unloaded,
+  // e.g. nxsCreateDispatch to exercise the fallback of an optional one
+  const char *disabled_env = std::getenv("NEXUS_DISABLE_FUNCTIONS");
+  std::string disabled = std::string(",") + (disabled_env ? disabled_env : "") + ",";
+
   auto loadFn = [&](nxs_function fn) {
     auto *fName = nxsGetFuncName(fn);
+    if (disabled.find(std::string(",") + fName + ",") != std::string::npos) {
+      NEXUS_LOG(NXS_LOG_WARN, "  Disabled symbol: ", fName);
+      runtimeFns[fn] = nullptr;
+      return;
+    }
     runtimeFns[fn] = dlsym(library, fName);
     dlError = dlerror();
     if (dlError) {
@@ -75,6 +90,9 @@ void RuntimeImpl::loadPlugin() {
       !runtimeFns[NF_nxsGetDeviceProperty])
     return;
 
+  cacheAPIProperties<NF_nxsGetRuntimeProperty>(properties,
+                                               {NP_Name, NP_Type, NP_Size});
+
   // Load devices
   if (auto deviceCount = getProperty(NP_Size)) {
     for (int i = 0; i < deviceCount->getValue<nxs_long>(); ++i)
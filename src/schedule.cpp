@@ -5,6 +5,7 @@
 #include <nexus/schedule.h>
 #include <nexus/stream.h>
 
+#include "_info_impl.h"
 #include "_schedule_impl.h"
 
 #define NEXUS_LOG_MODULE "schedule"
@@ -33,7 +34,20 @@ std::optional<Property> ScheduleImpl::getProperty(nxs_int prop) const {
   return rt->getAPIProperty<NF_nxsGetScheduleProperty>(prop, getId());
 }
 
+// Catalog metadata can mark kernels that never use the device barrier or
+// that take their arguments packed
+static nxs_uint getKernelSettings(Kernel kern, nxs_uint settings) {
+  if (auto info = kern.getInfo().getNode({})) {
+    if (info->get<bool>("BarrierFree"))
+      settings |= NXS_CommandSettings_BarrierFree;
+    if (info->get<bool>("PackedArgs"))
+      settings |= NXS_CommandSettings_PackedArgs;
+  }
+  return settings;
+}
+
 Command ScheduleImpl::createCommand(Kernel kern, nxs_uint settings) {
+  settings = getKernelSettings(kern, settings);
   auto *rt = getParentOfType<RuntimeImpl>();
   nxs_int cid =
       rt->runAPIFunction<NF_nxsCreateCommand>(getId(), kern.getId(), settings);
@@ -42,6 +56,17 @@ Command ScheduleImpl::createCommand(Kernel kern, nxs_uint settings) {
   return cmd;
 }
 
+Command ScheduleImpl::createCommand(Kernel kern, const CommandArgs &args,
+                                    nxs_dim3 gridSize, nxs_dim3 groupSize,
+                                    nxs_uint sharedMemorySize,
+                                    nxs_uint settings) {
+  settings = getKernelSettings(kern, settings);
+  Command cmd(detail::Impl(this, NXS_InvalidCommand, settings), kern, args,
+              gridSize, groupSize, sharedMemorySize);
+  if (cmd) commands.add(cmd);
+  return cmd;
+}
+
 Command ScheduleImpl::createSignalCommand(nxs_int signal_value,
                                           nxs_uint settings) {
   auto *dev = getParentOfType<DeviceImpl>();
@@ -95,6 +120,13 @@ Command Schedule::createCommand(Kernel kern, nxs_uint settings) {
   NEXUS_OBJ_MCALL(Command(), createCommand, kern, settings);
 }
 
+Command Schedule::createCommand(Kernel kern, const CommandArgs &args,
+                                nxs_dim3 gridSize, nxs_dim3 groupSize,
+                                nxs_uint sharedMemorySize, nxs_uint settings) {
+  NEXUS_OBJ_MCALL(Command(), createCommand, kern, args, gridSize, groupSize,
+                  sharedMemorySize, settings);
+}
+
 Command Schedule::createSignalCommand(nxs_int signal_value, nxs_uint settings) {
   NEXUS_OBJ_MCALL(Command(), createSignalCommand, signal_value, settings);
 }
@@ -41,9 +41,7 @@ Buffer SystemImpl::createBuffer(const Layout &layout, const void *hostData,
       normalized_layout.setDataType(data_type);
     }
   }
-  nxs_uint buffer_settings =
-      settings & (NXS_BufferSettings_OnHost | NXS_BufferSettings_OnDevice |
-                  NXS_BufferSettings_Maintain);
+  nxs_uint buffer_settings = settings & NXS_BufferSettings_Mask;
   NEXUS_LOG(NXS_LOG_NOTE, "createBuffer ", normalized_layout.getNumElements());
   nxs_uint id = buffers.size();
   Buffer buf(detail::Impl(this, id, buffer_settings), normalized_layout, hostData);
@@ -0,0 +1,137 @@
+// Per-launch overhead of the C++ API over calling the plugin directly.
+//
+// Usage: bench_api_overhead <runtime_name> <plugin_library> <kernel_file>
+//                           [kernel_name] [iterations]
+//
+// Every iteration rebinds the three buffer arguments of `kernel_name`
+// (default: add_vectors), finalizes the command and runs its schedule on a
+// 1x1 grid, once through nexus::Command / nexus::Schedule and once through
+// the nxs* symbols of plugin_library. The benchmark reports the median time
+// per iteration of the argument binding and of the whole launch for both,
+// and the difference is what the C++ layer costs per launch.
+
+#include <nexus.h>
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+template <typename Fn>
+static double median_ns(int iterations, Fn &&fn) {
+  std::vector<double> samples(iterations);
+  for (int i = 0; i < iterations; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    samples[i] = std::chrono::duration<double, std::nano>(end - start).count();
+  }
+  std::sort(samples.begin(), samples.end());
+  return samples[iterations / 2];
+}
+
+int main(int argc, char **argv) {
+  if (argc < 4) {
+    std::printf(
+        "Usage: %s <runtime_name> <plugin_library> <kernel_file> "
+        "[kernel_name] [iterations]\n",
+        argv[0]);
+    return 1;
+  }
+  std::string runtime_name = argv[1];
+  const char *plugin = argv[2];
+  std::string kernel_file = argv[3];
+  std::string kernel_name = argc > 4 ? argv[4] : "add_vectors";
+  int iterations = argc > 5 ? std::atoi(argv[5]) : 20000;
+
+  const size_t size = 32 * sizeof(float);
+  const nxs_dim3 grid{1, 1, 1}, block{1, 1, 1};
+
+  // C++ API
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  if (!runtime) {
+    std::printf("No runtimes found\n");
+    return 1;
+  }
+  auto dev0 = runtime.getDevice(0);
+  auto kern = dev0.createLibrary(kernel_file).getKernel(kernel_name);
+  if (!kern) {
+    std::printf("Kernel %s not found\n", kernel_name.c_str());
+    return 1;
+  }
+  nexus::Buffer bufs[3] = {dev0.createBuffer(size), dev0.createBuffer(size),
+                           dev0.createBuffer(size)};
+  auto stream = dev0.createStream();
+  auto sched = dev0.createSchedule();
+  auto cmd = sched.createCommand(kern);
+
+  auto api_bind = [&] {
+    for (nxs_uint a = 0; a < 3; ++a) cmd.setArgument(a, bufs[a]);
+    cmd.finalize(grid, block, 0);
+  };
+  double api_bind_ns = median_ns(iterations, api_bind);
+  double api_launch_ns = median_ns(iterations, [&] {
+    api_bind();
+    sched.run(stream);
+  });
+
+  // Plugin symbols
+  void *lib = dlopen(plugin, RTLD_NOW | RTLD_LOCAL);
+  if (!lib) {
+    std::printf("Failed to load %s: %s\n", plugin, dlerror());
+    return 1;
+  }
+#define NXS_BENCH_SYM(NAME) auto NAME = (NAME##_fn)dlsym(lib, #NAME)
+  NXS_BENCH_SYM(nxsCreateLibraryFromFile);
+  NXS_BENCH_SYM(nxsGetKernel);
+  NXS_BENCH_SYM(nxsCreateBuffer);
+  NXS_BENCH_SYM(nxsCreateStream);
+  NXS_BENCH_SYM(nxsCreateSchedule);
+  NXS_BENCH_SYM(nxsCreateCommand);
+  NXS_BENCH_SYM(nxsSetCommandArgument);
+  NXS_BENCH_SYM(nxsFinalizeCommand);
+  NXS_BENCH_SYM(nxsRunSchedule);
+#undef NXS_BENCH_SYM
+  if (!nxsCreateLibraryFromFile || !nxsGetKernel || !nxsCreateBuffer ||
+      !nxsCreateStream || !nxsCreateSchedule || !nxsCreateCommand ||
+      !nxsSetCommandArgument || !nxsFinalizeCommand || !nxsRunSchedule) {
+    std::printf("%s is missing dispatch entry points\n", plugin);
+    return 1;
+  }
+  nxs_int lib_id = nxsCreateLibraryFromFile(0, kernel_file.c_str(), 0);
+  nxs_int kernel_id = nxsGetKernel(lib_id, kernel_name.c_str());
+  nxs_buffer_layout shape{NXS_DataType_F32, 1, {32}, {1}};
+  nxs_int buf_ids[3];
+  for (auto &id : buf_ids) id = nxsCreateBuffer(0, shape, nullptr, 0);
+  nxs_int stream_id = nxsCreateStream(0, 0);
+  nxs_int sched_id = nxsCreateSchedule(0, 0);
+  nxs_int cmd_id = nxsCreateCommand(sched_id, kernel_id, 0);
+  if (nxs_failed(kernel_id) || nxs_failed(cmd_id)) {
+    std::printf("Failed to create the plugin command\n");
+    return 1;
+  }
+
+  auto direct_bind = [&] {
+    for (nxs_int a = 0; a < 3; ++a)
+      nxsSetCommandArgument(cmd_id, a, buf_ids[a], "", 0);
+    nxsFinalizeCommand(cmd_id, grid, block, 0);
+  };
+  double direct_bind_ns = median_ns(iterations, direct_bind);
+  double direct_launch_ns = median_ns(iterations, [&] {
+    direct_bind();
+    nxsRunSchedule(sched_id, stream_id, 0);
+  });
+
+  std::printf("%10s %14s %14s %14s\n", "", "C++ API(ns)", "plugin(ns)",
+              "overhead(ns)");
+  std::printf("%10s %14.1f %14.1f %14.1f\n", "bind", api_bind_ns,
+              direct_bind_ns, api_bind_ns - direct_bind_ns);
+  std::printf("%10s %14.1f %14.1f %14.1f\n", "launch", api_launch_ns,
+              direct_launch_ns, api_launch_ns - direct_launch_ns);
+  return 0;
+}
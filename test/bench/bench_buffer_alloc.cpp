@@ -0,0 +1,86 @@
+// Steady-state buffer allocation of a runtime plugin.
+//
+// Usage: bench_buffer_alloc <plugin_library> [iterations]
+//
+// Every iteration creates and releases the activations of a small MLP
+// (the same shapes each time) with nxsCreateBuffer/nxsReleaseBuffer, and
+// the benchmark reports the median iteration time plus the plugin's buffer
+// cache statistics. Run with NEXUS_CPU_BUFFER_CACHE_LIMIT=0 to compare
+// against plain system allocations.
+
+#include <nexus-api.h>
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::printf("Usage: %s <plugin_library> [iterations]\n", argv[0]);
+    return 1;
+  }
+  int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+
+  void *lib = dlopen(argv[1], RTLD_NOW | RTLD_LOCAL);
+  if (!lib) {
+    std::printf("Failed to load %s: %s\n", argv[1], dlerror());
+    return 1;
+  }
+  auto create_buffer = (nxsCreateBuffer_fn)dlsym(lib, "nxsCreateBuffer");
+  auto release_buffer = (nxsReleaseBuffer_fn)dlsym(lib, "nxsReleaseBuffer");
+  auto get_property =
+      (nxsGetRuntimeProperty_fn)dlsym(lib, "nxsGetRuntimeProperty");
+  if (!create_buffer || !release_buffer || !get_property) {
+    std::printf("%s is missing buffer entry points\n", argv[1]);
+    return 1;
+  }
+
+  // batch x hidden activations of a 4 layer MLP, plus an odd-sized tail
+  std::vector<nxs_ulong> elements = {64 * 4096, 64 * 4096, 64 * 1024,
+                                     64 * 1024, 64 * 1000};
+  std::vector<nxs_int> live(elements.size());
+
+  auto get_int = [&](nxs_uint prop) {
+    nxs_long value = 0;
+    size_t size = sizeof(value);
+    return get_property(prop, &value, &size) == NXS_Success ? value : -1;
+  };
+  auto get_flt = [&](nxs_uint prop) {
+    nxs_double value = 0;
+    size_t size = sizeof(value);
+    return get_property(prop, &value, &size) == NXS_Success ? value : -1.0;
+  };
+
+  std::vector<double> samples(iterations);
+  double fragmentation = 0;
+  for (int i = 0; i < iterations; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < elements.size(); ++b) {
+      nxs_buffer_layout shape{NXS_DataType_F32, 1, {elements[b]}, {1}};
+      live[b] = create_buffer(0, shape, nullptr, 0);
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (i == 0) fragmentation = get_flt(NP_BufferCacheFragmentation);
+    auto release_start = std::chrono::steady_clock::now();
+    for (auto id : live) release_buffer(id);
+    auto release_end = std::chrono::steady_clock::now();
+    samples[i] =
+        std::chrono::duration<double, std::micro>((end - start) +
+                                                  (release_end - release_start))
+            .count();
+  }
+  std::sort(samples.begin(), samples.end());
+
+  std::printf("iteration(us):   %10.2f (median of %d)\n",
+              samples[iterations / 2], iterations);
+  std::printf("cache hit rate:  %10.3f\n", get_flt(NP_BufferCacheHitRate));
+  std::printf("cached (bytes):  %10lld of %lld\n",
+              (long long)get_int(NP_BufferCacheSize),
+              (long long)get_int(NP_BufferCacheLimit));
+  std::printf("fragmentation:   %10.3f\n", fragmentation);
+  return 0;
+}
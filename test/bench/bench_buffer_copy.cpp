@@ -0,0 +1,68 @@
+// Host round trip of a buffer: create from host memory, then copy back.
+//
+// Usage: bench_buffer_copy <runtime_name> [max_size_mb] [runs]
+//
+// For buffer sizes from 1 MB up to max_size_mb the benchmark times
+// createBuffer(host) + copy(host) with a runtime-owned copy (maintained)
+// and with NXS_BufferSettings_ZeroCopy, and reports the median round trip
+// and the host bandwidth it represents (two passes over the data for the
+// maintained buffer).
+
+#include <nexus.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::printf("Usage: %s <runtime_name> [max_size_mb] [runs]\n", argv[0]);
+    return 1;
+  }
+  std::string runtime_name = argv[1];
+  size_t max_size_mb = argc > 2 ? std::atoi(argv[2]) : 64;
+  int runs = argc > 3 ? std::atoi(argv[3]) : 10;
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  if (!runtime) {
+    std::printf("No runtimes found\n");
+    return 1;
+  }
+  auto dev0 = runtime.getDevice(0);
+
+  std::printf("%10s %16s %16s %16s\n", "size(MB)", "maintain(ms)",
+              "zero-copy(ms)", "saved(GB/s)");
+
+  for (size_t size_mb = 1; size_mb <= max_size_mb; size_mb *= 4) {
+    size_t size = size_mb << 20;
+    std::vector<char> host(size, 1);
+
+    auto median_round_trip_ms = [&](nxs_uint settings) {
+      std::vector<double> samples(runs);
+      for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        auto buf = dev0.createBuffer(size, host.data(), settings);
+        buf.copy(host.data());
+        auto end = std::chrono::steady_clock::now();
+        samples[i] =
+            std::chrono::duration<double, std::milli>(end - start).count();
+      }
+      std::sort(samples.begin(), samples.end());
+      return samples[runs / 2];
+    };
+
+    double maintain_ms = median_round_trip_ms(0);
+    double zero_copy_ms = median_round_trip_ms(NXS_BufferSettings_ZeroCopy);
+    // bandwidth of the two copies the zero-copy buffer avoids
+    double saved_gbs = maintain_ms > zero_copy_ms
+                           ? 2.0 * size / ((maintain_ms - zero_copy_ms) * 1e6)
+                           : 0.0;
+    std::printf("%10zu %16.3f %16.3f %16.2f\n", size_mb, maintain_ms,
+                zero_copy_ms, saved_gbs);
+  }
+  return 0;
+}
@@ -0,0 +1,63 @@
+// Buffer fill bandwidth for pattern sizes from 1 to 64 bytes.
+//
+// Usage: bench_buffer_fill <runtime_name> [size_mb] [runs]
+//
+// Fills one buffer of size_mb (default 256) with patterns of 1, 2, 3, 4, 8,
+// 16, 32, 48 and 64 bytes and reports the median fill bandwidth next to
+// that of a single-threaded memset over host memory of the same size.
+
+#include <nexus.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::printf("Usage: %s <runtime_name> [size_mb] [runs]\n", argv[0]);
+    return 1;
+  }
+  std::string runtime_name = argv[1];
+  size_t size = size_t(argc > 2 ? std::atoi(argv[2]) : 256) << 20;
+  int runs = argc > 3 ? std::atoi(argv[3]) : 10;
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  if (!runtime) {
+    std::printf("No runtimes found\n");
+    return 1;
+  }
+  auto dev0 = runtime.getDevice(0);
+  auto buf = dev0.createBuffer(size);
+  std::vector<char> host(size, 1);
+
+  auto median_gbs = [&](auto &&fill) {
+    std::vector<double> samples(runs);
+    for (int i = 0; i < runs; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      fill();
+      auto end = std::chrono::steady_clock::now();
+      samples[i] = std::chrono::duration<double>(end - start).count();
+    }
+    std::sort(samples.begin(), samples.end());
+    return size / samples[runs / 2] * 1e-9;
+  };
+
+  double memset_gbs =
+      median_gbs([&] { std::memset(host.data(), 0x5a, size); });
+  std::printf("%12s %12s %12s\n", "pattern(B)", "fill(GB/s)", "vs memset");
+  std::printf("%12s %12.2f %12.2f\n", "memset", memset_gbs, 1.0);
+
+  unsigned char pattern[64];
+  for (int i = 0; i < 64; ++i) pattern[i] = (unsigned char)(0xa0 + i);
+  for (nxs_uint pattern_size : {1, 2, 3, 4, 8, 16, 32, 48, 64}) {
+    double fill_gbs = median_gbs([&] { buf.fill(pattern, pattern_size); });
+    std::printf("%12u %12.2f %12.2f\n", pattern_size, fill_gbs,
+                fill_gbs / memset_gbs);
+  }
+  return 0;
+}
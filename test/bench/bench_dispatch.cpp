@@ -0,0 +1,81 @@
+// Kernel invocation throughput of a runtime for an empty kernel.
+//
+// Usage: bench_dispatch <runtime_name> <kernel_file> [kernel_name] [runs]
+//
+// Launches `kernel_name` (default: empty_kernel) over a range of grid sizes
+// and reports per-launch latency and kernel invocations per second, where
+// one invocation is one (block, warp) call of the kernel. The replay column
+// is the latency of the same schedule captured with
+// NXS_ExecutionSettings_Capture.
+
+#include <nexus.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::printf("Usage: %s <runtime_name> <kernel_file> [kernel_name] [runs]\n",
+                argv[0]);
+    return 1;
+  }
+  std::string runtime_name = argv[1];
+  std::string kernel_file = argv[2];
+  std::string kernel_name = argc > 3 ? argv[3] : "empty_kernel";
+  int runs = argc > 4 ? std::atoi(argv[4]) : 200;
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  if (!runtime) {
+    std::printf("No runtimes found\n");
+    return 1;
+  }
+  auto dev0 = runtime.getDevice(0);
+  auto nlib = dev0.createLibrary(kernel_file);
+  auto kern = nlib.getKernel(kernel_name);
+  if (!kern) {
+    std::printf("Kernel %s not found\n", kernel_name.c_str());
+    return 1;
+  }
+  auto stream0 = dev0.createStream();
+
+  std::printf("%10s %8s %14s %16s %14s\n", "grid", "block", "launch(us)",
+              "invocations/s", "replay(us)");
+
+  auto median_launch_us = [&](nexus::Schedule &sched) {
+    std::vector<double> samples(runs);
+    for (int i = 0; i < runs; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      sched.run(stream0);
+      auto end = std::chrono::steady_clock::now();
+      samples[i] =
+          std::chrono::duration<double, std::micro>(end - start).count();
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[runs / 2];
+  };
+
+  const nxs_uint block = 32;
+  for (nxs_uint grid : {1u, 16u, 256u, 4096u, 65536u}) {
+    auto sched = dev0.createSchedule();
+    auto cmd = sched.createCommand(kern);
+    cmd.finalize({grid, 1, 1}, {block, 1, 1}, 0);
+    sched.run(stream0);  // warm up
+
+    auto captured = dev0.createSchedule();
+    auto ccmd = captured.createCommand(kern);
+    ccmd.finalize({grid, 1, 1}, {block, 1, 1}, 0);
+    captured.run(stream0, NXS_ExecutionSettings_Capture);
+
+    double median_us = median_launch_us(sched);
+    double replay_us = median_launch_us(captured);
+    double invocations = double(grid) * block;
+    std::printf("%10u %8u %14.2f %16.3e %14.2f\n", grid, block, median_us,
+                invocations / (median_us * 1e-6), replay_us);
+  }
+  return 0;
+}
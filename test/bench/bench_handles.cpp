@@ -0,0 +1,156 @@
+// Contention on the runtime object handle table.
+//
+// Usage: bench_handles [max_threads] [iterations] [plugin_library]
+//
+// For every thread count in 1..max_threads each thread creates, looks up and
+// releases `iterations` objects and the benchmark reports the throughput in
+// millions of operations per second:
+//  - pool:   rt::Pool<rt::Object> (the previous table), with the hit rate
+//            of its per-thread magazines
+//  - table:  rt::HandleTable<rt::Object>
+//  - plugin: nxsCreateBuffer/nxsReleaseBuffer and nxsCreateSignalCommand of
+//            a runtime plugin, the commands released with their schedule
+//            (only when plugin_library is given)
+
+#include <nexus-api.h>
+#include <rt_handle_table.h>
+#include <rt_object.h>
+#include <rt_pool.h>
+
+#include <dlfcn.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace nxs;
+
+template <typename Fn>
+static double run_threads(size_t num_threads, size_t iterations, Fn &&fn) {
+  std::atomic<size_t> ready{0};
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      fn(t, iterations);
+    });
+  while (ready.load() != num_threads) std::this_thread::yield();
+  auto start = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto &th : threads) th.join();
+  auto end = std::chrono::steady_clock::now();
+  double secs = std::chrono::duration<double>(end - start).count();
+  return double(num_threads * iterations) / secs / 1e6;
+}
+
+// Each thread keeps a small window of live handles so releases do not
+// immediately hand the same slot back.
+static constexpr size_t window = 16;
+
+int main(int argc, char **argv) {
+  size_t max_threads =
+      argc > 1 ? std::atoi(argv[1]) : std::thread::hardware_concurrency();
+  size_t iterations = argc > 2 ? std::atoi(argv[2]) : 200000;
+  const char *plugin = argc > 3 ? argv[3] : nullptr;
+
+  nxsCreateBuffer_fn create_buffer = nullptr;
+  nxsReleaseBuffer_fn release_buffer = nullptr;
+  nxsCreateSchedule_fn create_schedule = nullptr;
+  nxsReleaseSchedule_fn release_schedule = nullptr;
+  nxsCreateEvent_fn create_event = nullptr;
+  nxsReleaseEvent_fn release_event = nullptr;
+  nxsCreateSignalCommand_fn create_signal = nullptr;
+  if (plugin) {
+    void *lib = dlopen(plugin, RTLD_NOW | RTLD_LOCAL);
+    if (!lib) {
+      std::printf("Failed to load %s: %s\n", plugin, dlerror());
+      return 1;
+    }
+    create_buffer = (nxsCreateBuffer_fn)dlsym(lib, "nxsCreateBuffer");
+    release_buffer = (nxsReleaseBuffer_fn)dlsym(lib, "nxsReleaseBuffer");
+    create_schedule = (nxsCreateSchedule_fn)dlsym(lib, "nxsCreateSchedule");
+    release_schedule =
+        (nxsReleaseSchedule_fn)dlsym(lib, "nxsReleaseSchedule");
+    create_event = (nxsCreateEvent_fn)dlsym(lib, "nxsCreateEvent");
+    release_event = (nxsReleaseEvent_fn)dlsym(lib, "nxsReleaseEvent");
+    create_signal =
+        (nxsCreateSignalCommand_fn)dlsym(lib, "nxsCreateSignalCommand");
+    if (!create_buffer || !release_buffer || !create_schedule ||
+        !release_schedule || !create_event || !release_event ||
+        !create_signal) {
+      std::printf("%s is missing buffer/command entry points\n", plugin);
+      return 1;
+    }
+  }
+
+  std::printf("iterations/thread: %zu\n", iterations);
+  std::printf("%8s %12s %8s %12s %12s\n", "threads", "pool(M/s)", "hit%",
+              "table(M/s)", plugin ? "plugin(M/s)" : "");
+
+  for (size_t threads = 1; threads <= max_threads; ++threads) {
+    rt::Pool<rt::Object> pool;
+    double pool_rate = run_threads(threads, iterations, [&](size_t,
+                                                             size_t n) {
+      nxs_int live[window];
+      for (size_t i = 0; i < window; ++i) live[i] = pool.acquire(nxs_long(i));
+      for (size_t i = 0; i < n; ++i) {
+        auto &slot = live[i % window];
+        if (!pool.get(slot)) std::abort();
+        pool.release(slot);
+        slot = pool.acquire(nxs_long(i));
+      }
+      for (auto id : live) pool.release(id);
+      pool.flush_local();
+    });
+    double pool_hits = 100.0 * pool.get_cache_stats().hit_rate();
+
+    rt::HandleTable<rt::Object> table;
+    double table_rate = run_threads(threads, iterations, [&](size_t,
+                                                              size_t n) {
+      nxs_int live[window];
+      for (size_t i = 0; i < window; ++i) live[i] = table.acquire(nxs_long(i));
+      for (size_t i = 0; i < n; ++i) {
+        auto &slot = live[i % window];
+        if (!table.get(slot)) std::abort();
+        table.release(slot);
+        slot = table.acquire(nxs_long(i));
+      }
+      for (auto id : live) table.release(id);
+    });
+
+    double plugin_rate = 0;
+    if (plugin) {
+      nxs_int event = create_event(0, NXS_EventType_Signal, 0);
+      nxs_buffer_layout shape{NXS_DataType_F32, 1, {256}, {1}};
+      // one create+release of a buffer and of a command per iteration
+      plugin_rate = run_threads(threads, iterations, [&](size_t, size_t n) {
+        nxs_int schedule = create_schedule(0, 0);
+        for (size_t i = 0; i < n; ++i) {
+          nxs_int buf = create_buffer(0, shape, nullptr, 0);
+          nxs_int cmd = create_signal(schedule, event, nxs_int(i), 0);
+          if (buf < 0 || cmd < 0) std::abort();
+          release_buffer(buf);
+          if ((i & 63) == 63) {
+            release_schedule(schedule);
+            schedule = create_schedule(0, 0);
+          }
+        }
+        release_schedule(schedule);
+      });
+      release_event(event);
+    }
+
+    if (plugin)
+      std::printf("%8zu %12.2f %8.1f %12.2f %12.2f\n", threads, pool_rate,
+                  pool_hits, table_rate, plugin_rate);
+    else
+      std::printf("%8zu %12.2f %8.1f %12.2f\n", threads, pool_rate,
+                  pool_hits, table_rate);
+  }
+  return 0;
+}
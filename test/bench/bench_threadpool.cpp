@@ -0,0 +1,54 @@
+// Launch latency of the CPU plugin's ThreadPool::parallel_for.
+//
+// Usage: bench_threadpool [max_teams] [iterations]
+//
+// For every team count in 1..max_teams the benchmark times a fork-join over
+// empty teams and reports the min/median/p99 latency in microseconds.
+
+#include <nexus-api.h>
+
+#define NXSAPI_LOG_MODULE "bench_threadpool"
+#include <nexus-api/nxs_log.h>
+
+#include "threadpool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+int main(int argc, char **argv) {
+  size_t num_workers = std::thread::hardware_concurrency();
+  size_t max_teams = argc > 1 ? std::atoi(argv[1]) : num_workers;
+  size_t iterations = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+  ThreadPool pool(num_workers);
+  std::atomic<size_t> sink{0};
+
+  std::printf("workers: %zu, iterations: %zu\n", num_workers, iterations);
+  std::printf("%8s %12s %12s %12s\n", "teams", "min(us)", "median(us)",
+              "p99(us)");
+
+  std::vector<double> samples(iterations);
+  for (size_t teams = 1; teams <= max_teams; ++teams) {
+    // warm up: wake every worker and fault in the deques
+    for (size_t i = 0; i < 64; ++i)
+      pool.parallel_for(teams, [&](size_t t) {
+        sink.fetch_add(t + 1, std::memory_order_relaxed);
+      });
+
+    for (size_t i = 0; i < iterations; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      pool.parallel_for(teams, [&](size_t t) {
+        sink.fetch_add(t + 1, std::memory_order_relaxed);
+      });
+      auto end = std::chrono::steady_clock::now();
+      samples[i] = std::chrono::duration<double, std::micro>(end - start).count();
+    }
+    std::sort(samples.begin(), samples.end());
+    std::printf("%8zu %12.2f %12.2f %12.2f\n", teams, samples.front(),
+                samples[iterations / 2], samples[iterations * 99 / 100]);
+  }
+  return sink.load() == 0 ? 1 : 0;
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <nexus.h>
 
+#include <dlfcn.h>
+
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
@@ -12,7 +14,8 @@
 int g_argc;
 char** g_argv;
 
-int test_basic_kernel(int argc, char** argv) {
+int test_basic_kernel(int argc, char** argv, nxs_uint command_settings = 0,
+                      bool batched = false) {
   if (argc < 4) {
     std::cout << "Usage: " << argv[0]
               << " <runtime_name> <kernel_file> <kernel_name>" << std::endl;
@@ -71,12 +74,18 @@ int test_basic_kernel(int argc, char** argv) {
 
   auto sched = dev0.createSchedule();
 
-  auto cmd = sched.createCommand(kern);
-  cmd.setArgument(0, buf0);
-  cmd.setArgument(1, buf1);
-  cmd.setArgument(2, buf2);
+  if (batched) {
+    auto cmd = sched.createCommand(kern, {buf0, buf1, buf2}, {32, 1, 1},
+                                   {32, 1, 1}, 0, command_settings);
+    if (!cmd) return FAILURE;
+  } else {
+    auto cmd = sched.createCommand(kern, command_settings);
+    cmd.setArgument(0, buf0);
+    cmd.setArgument(1, buf1);
+    cmd.setArgument(2, buf2);
 
-  cmd.finalize({32,1,1}, {32,1,1}, 0);
+    cmd.finalize({32,1,1}, {32,1,1}, 0);
+  }
 
   sched.run(stream0, NXS_ExecutionSettings_Timing);
 
@@ -99,6 +108,148 @@ int test_basic_kernel(int argc, char** argv) {
   return SUCCESS;
 }
 
+// A command with an argument that cannot be bound is not created, and
+// nothing is left behind in the schedule
+int test_invalid_argument(int argc, char** argv) {
+  if (argc < 4) return FAILURE;
+  auto runtime = nexus::getSystem().getRuntime(argv[1]);
+  if (!runtime || runtime.getDevices().empty()) return FAILURE;
+  auto dev0 = runtime.getDevice(0);
+
+  auto nlib = dev0.createLibrary(std::string(argv[2]));
+  auto kern = nlib.getKernel(argv[3]);
+  if (!kern) return FAILURE;
+
+  std::vector<float> vec(1024, 1.0);
+  auto buf0 = dev0.createBuffer(vec.size() * sizeof(float), vec.data());
+  auto buf1 = dev0.createBuffer(vec.size() * sizeof(float), vec.data());
+  auto stream0 = dev0.createStream();
+  auto sched = dev0.createSchedule();
+
+  auto cmd = sched.createCommand(kern, {buf0, nexus::Buffer(), buf1},
+                                 {32, 1, 1}, {32, 1, 1}, 0);
+  if (cmd || !sched.getCommands().empty()) return FAILURE;
+  if (sched.run(stream0) != NXS_Success) return FAILURE;
+  if (sched.getProp<nxs_long>(NP_StepCount) != 0) return FAILURE;
+  return SUCCESS;
+}
+
+// The core API keeps libraries alive as long as their device, so library
+// release is driven through the plugin directly
+struct Plugin {
+  nxsCreateLibrary_fn create_library = nullptr;
+  nxsReleaseLibrary_fn release_library = nullptr;
+  nxsGetKernel_fn get_kernel = nullptr;
+  nxsCreateBuffer_fn create_buffer = nullptr;
+  nxsCopyBuffer_fn copy_buffer = nullptr;
+  nxsReleaseBuffer_fn release_buffer = nullptr;
+  nxsCreateSchedule_fn create_schedule = nullptr;
+  nxsCreateDispatch_fn create_dispatch = nullptr;
+  nxsRunSchedule_fn run_schedule = nullptr;
+  nxsReleaseSchedule_fn release_schedule = nullptr;
+
+  explicit operator bool() const {
+    return create_library && release_library && get_kernel &&
+           create_buffer && copy_buffer && release_buffer &&
+           create_schedule && create_dispatch && run_schedule &&
+           release_schedule;
+  }
+};
+
+Plugin loadPlugin(const std::string& runtime_name) {
+  std::string path = "./runtime_libs/lib" + runtime_name + "_plugin.so";
+  Plugin plugin;
+  void* lib = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!lib) return plugin;
+#define LOAD(field, name) plugin.field = (name##_fn)dlsym(lib, #name)
+  LOAD(create_library, nxsCreateLibrary);
+  LOAD(release_library, nxsReleaseLibrary);
+  LOAD(get_kernel, nxsGetKernel);
+  LOAD(create_buffer, nxsCreateBuffer);
+  LOAD(copy_buffer, nxsCopyBuffer);
+  LOAD(release_buffer, nxsReleaseBuffer);
+  LOAD(create_schedule, nxsCreateSchedule);
+  LOAD(create_dispatch, nxsCreateDispatch);
+  LOAD(run_schedule, nxsRunSchedule);
+  LOAD(release_schedule, nxsReleaseSchedule);
+#undef LOAD
+  return plugin;
+}
+
+std::vector<char> readImage(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<char>((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+}
+
+// A barrier-free library is released and a library whose kernel waits on
+// the barrier is loaded in its place, likely at the same addresses. The new
+// kernel must still get a barrier of its own.
+int test_barrier_after_release(int argc, char** argv) {
+  if (argc < 3) return FAILURE;
+  auto plugin = loadPlugin(argv[1]);
+  if (!plugin) return FAILURE;
+
+  std::string kernel_file = argv[2];
+  std::string shared_file =
+      kernel_file.substr(0, kernel_file.find_last_of('/') + 1) +
+      "cpu_shared_kernel.so";
+  auto image = readImage(kernel_file);
+  auto shared_image = readImage(shared_file);
+  if (image.empty() || shared_image.empty()) {
+    std::cout << "Failed to read " << kernel_file << " or " << shared_file
+              << std::endl;
+    return FAILURE;
+  }
+
+  nxs_int lib = plugin.create_library(0, image.data(), image.size(), 0);
+  if (!nxs_valid_id(lib)) return FAILURE;
+  nxs_int kern = plugin.get_kernel(lib, "add_vectors");
+  if (!nxs_valid_id(kern)) return FAILURE;
+  if (plugin.release_library(lib) != NXS_Success) return FAILURE;
+
+  lib = plugin.create_library(0, shared_image.data(), shared_image.size(), 0);
+  if (!nxs_valid_id(lib)) return FAILURE;
+  kern = plugin.get_kernel(lib, "reverse_block");
+  if (!nxs_valid_id(kern)) return FAILURE;
+
+  const nxs_uint block = 32;
+  const nxs_uint grid = 4;
+  size_t vsize = block * grid;
+  std::vector<float> vecIn(vsize);
+  std::iota(vecIn.begin(), vecIn.end(), 0.f);
+  std::vector<float> vecOut(vsize, 0.0);
+  nxs_buffer_layout shape{NXS_DataType_U8, 1, {vsize * sizeof(float)}, {1}};
+  nxs_int in = plugin.create_buffer(0, shape, vecIn.data(), 0);
+  nxs_int out = plugin.create_buffer(0, shape, vecOut.data(), 0);
+  nxs_int sched = plugin.create_schedule(0, 0);
+  nxs_command_arg args[] = {{in, nullptr, "", 0}, {out, nullptr, "", 0}};
+  nxs_int cmd = plugin.create_dispatch(sched, kern, args, 2, {grid, 1, 1},
+                                       {block, 1, 1}, block * sizeof(float),
+                                       0);
+  if (!nxs_valid_id(cmd) ||
+      plugin.run_schedule(sched, NXS_InvalidObject, 0) != NXS_Success ||
+      plugin.copy_buffer(out, vecOut.data(), NXS_BufferDeviceToHost) !=
+          NXS_Success)
+    return FAILURE;
+
+  int result = SUCCESS;
+  for (size_t i = 0; i < vsize; ++i) {
+    float expected = vecIn[i - i % block + block - 1 - i % block];
+    if (vecOut[i] != expected) {
+      std::cout << "Fail: result[" << i << "] = " << vecOut[i] << std::endl;
+      result = FAILURE;
+      break;
+    }
+  }
+
+  plugin.release_schedule(sched);
+  plugin.release_buffer(in);
+  plugin.release_buffer(out);
+  plugin.release_library(lib);
+  return result;
+}
+
 // Create the NexusIntegration test fixture class
 class NexusIntegration : public ::testing::Test {
  protected:
@@ -111,10 +262,138 @@ TEST_F(NexusIntegration, BASIC_KERNEL) {
   EXPECT_EQ(result, SUCCESS);
 }
 
+TEST_F(NexusIntegration, BASIC_KERNEL_DYNAMIC) {
+  int result = test_basic_kernel(
+      g_argc, g_argv,
+      NXS_CommandSettings_ScheduleDynamic | NXS_COMMAND_CHUNK_SIZE(3));
+  EXPECT_EQ(result, SUCCESS);
+}
+
+TEST_F(NexusIntegration, BASIC_KERNEL_GUIDED) {
+  int result =
+      test_basic_kernel(g_argc, g_argv, NXS_CommandSettings_ScheduleGuided);
+  EXPECT_EQ(result, SUCCESS);
+}
+
+TEST_F(NexusIntegration, BASIC_KERNEL_BARRIER_FREE) {
+  int result =
+      test_basic_kernel(g_argc, g_argv, NXS_CommandSettings_BarrierFree);
+  EXPECT_EQ(result, SUCCESS);
+}
+
+// Barrier-free marks do not outlive the library of the kernel
+TEST_F(NexusIntegration, BARRIER_KERNEL_AFTER_RELEASE) {
+  ASSERT_GE(g_argc, 3);
+  if (std::string(g_argv[1]) != "cpu") GTEST_SKIP();
+  int result = test_barrier_after_release(g_argc, g_argv);
+  EXPECT_EQ(result, SUCCESS);
+}
+
+TEST_F(NexusIntegration, BASIC_KERNEL_BATCHED) {
+  int result = test_basic_kernel(g_argc, g_argv, 0, true);
+  EXPECT_EQ(result, SUCCESS);
+}
+
+TEST_F(NexusIntegration, BATCHED_INVALID_ARGUMENT) {
+  int result = test_invalid_argument(g_argc, g_argv);
+  EXPECT_EQ(result, SUCCESS);
+}
+
+// Per-argument calls where the runtime has no nxsCreateDispatch; the
+// plugin is loaded without it in a fresh process
+TEST_F(NexusIntegration, BATCHED_FALLBACK) {
+  EXPECT_EXIT(
+      {
+        setenv("NEXUS_DISABLE_FUNCTIONS", "nxsCreateDispatch", 1);
+        int result = test_basic_kernel(g_argc, g_argv, 0, true);
+        if (result == SUCCESS) result = test_invalid_argument(g_argc, g_argv);
+        std::exit(result);
+      },
+      ::testing::ExitedWithCode(SUCCESS), "");
+}
+
+// More arguments than fit the 32 pointer ABI, passed as one packed frame
+TEST_F(NexusIntegration, PACKED_ARGS_KERNEL) {
+  ASSERT_GE(g_argc, 3);
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(g_argv[1]);
+  ASSERT_TRUE(runtime && !runtime.getDevices().empty());
+  if (runtime.getProp<std::string>(NP_Name) != "cpu") GTEST_SKIP();
+  auto dev0 = runtime.getDevice(0);
+
+  const size_t vsize = 1024;
+  const int inputs = 40;
+  auto nlib = dev0.createLibrary(g_argv[2]);
+  auto kern = nlib.getKernel("sum_inputs_packed");
+  ASSERT_TRUE(kern);
+
+  auto sched = dev0.createSchedule();
+  auto cmd = sched.createCommand(kern, NXS_CommandSettings_PackedArgs);
+  std::vector<std::vector<float>> host(inputs);
+  std::vector<nexus::Buffer> bufs;
+  for (int k = 0; k < inputs; ++k) {
+    host[k].assign(vsize, float(k));
+    bufs.push_back(dev0.createBuffer(vsize * sizeof(float), host[k].data()));
+    cmd.setArgument(k, bufs.back());
+  }
+  std::vector<float> result(vsize, 0.0f);
+  auto out = dev0.createBuffer(vsize * sizeof(float), result.data());
+  cmd.setArgument(inputs, out);
+  ASSERT_EQ(cmd.finalize({32, 1, 1}, {32, 1, 1}, 0), NXS_Success);
+
+  auto stream0 = dev0.createStream();
+  sched.run(stream0);
+  out.copy(result.data(), NXS_BufferDeviceToHost);
+  for (size_t i = 0; i < vsize; ++i)
+    ASSERT_EQ(result[i], inputs * (inputs - 1) / 2) << "at " << i;
+}
+
+// 31 arguments leave room for the launch size only; such kernels predate
+// the packed ABI and must keep working
+TEST_F(NexusIntegration, MAX_POINTER_ARGS_KERNEL) {
+  ASSERT_GE(g_argc, 3);
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(g_argv[1]);
+  ASSERT_TRUE(runtime && !runtime.getDevices().empty());
+  if (runtime.getProp<std::string>(NP_Name) != "cpu") GTEST_SKIP();
+  auto dev0 = runtime.getDevice(0);
+
+  const nxs_uint vsize = 64;
+  const int inputs = 30;
+  auto nlib = dev0.createLibrary(g_argv[2]);
+  auto kern = nlib.getKernel("sum_inputs_31");
+  ASSERT_TRUE(kern);
+
+  auto sched = dev0.createSchedule();
+  auto cmd = sched.createCommand(kern);
+  std::vector<std::vector<float>> host(inputs);
+  std::vector<nexus::Buffer> bufs;
+  for (int k = 0; k < inputs; ++k) {
+    host[k].assign(vsize, float(k));
+    bufs.push_back(dev0.createBuffer(vsize * sizeof(float), host[k].data()));
+    cmd.setArgument(k, bufs.back());
+  }
+  // one extra word holds the kernel's element ticket
+  std::vector<float> result(vsize + 1, 0.0f);
+  auto out = dev0.createBuffer(result.size() * sizeof(float), result.data());
+  cmd.setArgument(inputs, out);
+  // one work-item per element
+  const nxs_uint block = 32;
+  ASSERT_EQ(cmd.finalize({vsize / block, 1, 1}, {block, 1, 1}, 0),
+            NXS_Success);
+
+  auto stream0 = dev0.createStream();
+  sched.run(stream0);
+  out.copy(result.data(), NXS_BufferDeviceToHost);
+  for (size_t i = 0; i < vsize; ++i)
+    ASSERT_EQ(result[i], inputs * (inputs - 1) / 2) << "at " << i;
+}
+
 int main(int argc, char** argv) {
   g_argc = argc;
   g_argv = argv;
 
   ::testing::InitGoogleTest(&argc, argv);
+  ::testing::GTEST_FLAG(death_test_style) = "threadsafe";
   return RUN_ALL_TESTS();
 }
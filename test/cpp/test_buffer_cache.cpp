@@ -0,0 +1,161 @@
+// Buffer cache of the CPU runtime plugin.
+//
+// Usage: test_buffer_cache [runtime_name]
+//
+// Buffers of the core API live as long as their device, so the tests drive
+// the plugin's nxsCreateBuffer/nxsReleaseBuffer directly and observe the
+// cache through its runtime properties. The plugin reads
+// NEXUS_CPU_BUFFER_CACHE_LIMIT when it is first used, so main sets a small
+// limit before loading it and the disabled cache runs in a child process.
+
+#include <gtest/gtest.h>
+#include <nexus-api.h>
+
+#include <dlfcn.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+int g_argc;
+char** g_argv;
+
+namespace {
+
+constexpr nxs_long kCacheLimit = 64 * 1024;
+
+struct Plugin {
+  nxsCreateBuffer_fn create_buffer = nullptr;
+  nxsReleaseBuffer_fn release_buffer = nullptr;
+  nxsGetRuntimeProperty_fn get_property = nullptr;
+
+  explicit operator bool() const {
+    return create_buffer && release_buffer && get_property;
+  }
+
+  nxs_int create(nxs_ulong bytes) const {
+    nxs_buffer_layout shape{NXS_DataType_U8, 1, {bytes}, {1}};
+    return create_buffer(0, shape, nullptr, 0);
+  }
+
+  nxs_long getInt(nxs_uint prop) const {
+    nxs_long value = -1;
+    size_t size = sizeof(value);
+    get_property(prop, &value, &size);
+    return value;
+  }
+
+  nxs_double getFlt(nxs_uint prop) const {
+    nxs_double value = -1;
+    size_t size = sizeof(value);
+    get_property(prop, &value, &size);
+    return value;
+  }
+};
+
+Plugin loadPlugin() {
+  std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
+  std::string path = "./runtime_libs/lib" + runtime_name + "_plugin.so";
+  Plugin plugin;
+  void* lib = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!lib) return plugin;
+  plugin.create_buffer = (nxsCreateBuffer_fn)dlsym(lib, "nxsCreateBuffer");
+  plugin.release_buffer = (nxsReleaseBuffer_fn)dlsym(lib, "nxsReleaseBuffer");
+  plugin.get_property =
+      (nxsGetRuntimeProperty_fn)dlsym(lib, "nxsGetRuntimeProperty");
+  return plugin;
+}
+
+}  // namespace
+
+TEST(BufferCacheTest, RoundsToSizeClass) {
+  auto plugin = loadPlugin();
+  ASSERT_TRUE(plugin);
+
+  // (requested, class): 256 bytes minimum, then four classes per power of 2
+  std::vector<std::pair<nxs_ulong, nxs_long>> sizes = {
+      {4, 256}, {257, 320}, {1000, 1024}, {1025, 1280}};
+  for (auto& size : sizes) {
+    nxs_long cached = plugin.getInt(NP_BufferCacheSize);
+    nxs_int id = plugin.create(size.first);
+    ASSERT_TRUE(nxs_valid_id(id));
+    // only this buffer is live: its rounding loss is the fragmentation
+    EXPECT_DOUBLE_EQ(plugin.getFlt(NP_BufferCacheFragmentation),
+                     double(size.second - size.first) / double(size.second))
+        << "size " << size.first;
+    ASSERT_EQ(plugin.release_buffer(id), NXS_Success);
+    EXPECT_EQ(plugin.getInt(NP_BufferCacheSize), cached + size.second)
+        << "size " << size.first;
+    EXPECT_DOUBLE_EQ(plugin.getFlt(NP_BufferCacheFragmentation), 0.0);
+  }
+}
+
+TEST(BufferCacheTest, ReusesReleasedMemory) {
+  auto plugin = loadPlugin();
+  ASSERT_TRUE(plugin);
+
+  nxs_int id = plugin.create(3000);
+  ASSERT_TRUE(nxs_valid_id(id));
+  ASSERT_EQ(plugin.release_buffer(id), NXS_Success);
+  nxs_long cached = plugin.getInt(NP_BufferCacheSize);
+  double hit_rate = plugin.getFlt(NP_BufferCacheHitRate);
+
+  // a different size of the same class takes the cached memory
+  id = plugin.create(3050);
+  ASSERT_TRUE(nxs_valid_id(id));
+  EXPECT_EQ(plugin.getInt(NP_BufferCacheSize), cached - 3072);
+  EXPECT_GT(plugin.getFlt(NP_BufferCacheHitRate), hit_rate);
+  EXPECT_LE(plugin.getFlt(NP_BufferCacheHitRate), 1.0);
+  ASSERT_EQ(plugin.release_buffer(id), NXS_Success);
+  EXPECT_EQ(plugin.getInt(NP_BufferCacheSize), cached);
+}
+
+TEST(BufferCacheTest, TrimsToLimit) {
+  auto plugin = loadPlugin();
+  ASSERT_TRUE(plugin);
+  ASSERT_EQ(plugin.getInt(NP_BufferCacheLimit), kCacheLimit);
+
+  std::vector<nxs_int> live;
+  for (int i = 0; i < 3; ++i) {
+    live.push_back(plugin.create(kCacheLimit / 2));
+    ASSERT_TRUE(nxs_valid_id(live.back()));
+  }
+  for (auto id : live) ASSERT_EQ(plugin.release_buffer(id), NXS_Success);
+  EXPECT_LE(plugin.getInt(NP_BufferCacheSize), kCacheLimit);
+  EXPECT_GT(plugin.getInt(NP_BufferCacheSize), 0);
+
+  // larger than the limit: freed straight away
+  nxs_long cached = plugin.getInt(NP_BufferCacheSize);
+  nxs_int id = plugin.create(2 * kCacheLimit);
+  ASSERT_TRUE(nxs_valid_id(id));
+  ASSERT_EQ(plugin.release_buffer(id), NXS_Success);
+  EXPECT_EQ(plugin.getInt(NP_BufferCacheSize), cached);
+}
+
+TEST(BufferCacheTest, DisabledByZeroLimit) {
+  // a fresh process, so the plugin is loaded with the new limit
+  EXPECT_EXIT(
+      {
+        setenv("NEXUS_CPU_BUFFER_CACHE_LIMIT", "0", 1);
+        auto plugin = loadPlugin();
+        bool ok = plugin && plugin.getInt(NP_BufferCacheLimit) == 0;
+        for (int i = 0; ok && i < 2; ++i) {
+          nxs_int id = plugin.create(1000);
+          ok = nxs_valid_id(id) && plugin.release_buffer(id) == NXS_Success &&
+               plugin.getInt(NP_BufferCacheSize) == 0;
+        }
+        ok = ok && plugin.getFlt(NP_BufferCacheHitRate) == 0.0;
+        std::exit(ok ? 0 : 1);
+      },
+      ::testing::ExitedWithCode(0), "");
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  ::testing::GTEST_FLAG(death_test_style) = "threadsafe";
+  g_argc = argc;
+  g_argv = argv;
+  setenv("NEXUS_CPU_BUFFER_CACHE_LIMIT", std::to_string(kCacheLimit).c_str(),
+         1);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 #include <nexus.h>
+
+#include <dlfcn.h>
+
+#include <cstdlib>
+#include <string>
+#include <tuple>
 #include <vector>
 
 #define SUCCESS 0
@@ -8,17 +14,18 @@
 int g_argc;
 char** g_argv;
 
-class BufferFillTest : public ::testing::TestWithParam<size_t> {};
+class BufferFillTest
+    : public ::testing::TestWithParam<std::tuple<size_t, size_t>> {};
 
 TEST_P(BufferFillTest, PatternSize) {
   std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
-  size_t pattern_size = GetParam();
+  size_t buffer_size = std::get<0>(GetParam());
+  size_t pattern_size = std::get<1>(GetParam());
 
   auto sys = nexus::getSystem();
   auto runtime = sys.getRuntime(runtime_name);
   ASSERT_TRUE(runtime && !runtime.getDevices().empty());
   auto dev = runtime.getDevice(0);
-  size_t buffer_size = 1024;
   auto buf = dev.createBuffer(buffer_size, nullptr);
 
   std::vector<uint8_t> pattern(std::max(pattern_size, size_t{1}), 0);
@@ -34,13 +41,19 @@ TEST_P(BufferFillTest, PatternSize) {
     size_t effective_size = pattern_size == 0 ? 1 : pattern_size;
     for (size_t i = 0; i < buffer_size; ++i) {
       ASSERT_EQ(host_out[i], pattern[i % effective_size])
-        << "Mismatch at byte " << i << " for pattern_size=" << pattern_size;
+        << "Mismatch at byte " << i << " for pattern_size=" << pattern_size
+        << ", buffer_size=" << buffer_size;
     }
   }
 }
 
+// the large buffer is odd-sized and split across workers
 INSTANTIATE_TEST_SUITE_P(AllPatternSizes, BufferFillTest,
-  ::testing::Values(size_t{0}, size_t{1}, size_t{2}, size_t{4}));
+  ::testing::Combine(
+    ::testing::Values(size_t{1024}, size_t{(3 << 20) + 100}),
+    ::testing::Values(size_t{0}, size_t{1}, size_t{2}, size_t{3}, size_t{4},
+                      size_t{8}, size_t{16}, size_t{48}, size_t{64},
+                      size_t{100})));
 
 class BufferShapeTest : public ::testing::TestWithParam<std::vector<size_t>> {};
 
@@ -64,10 +77,404 @@ TEST_P(BufferShapeTest, Shape) {
 INSTANTIATE_TEST_SUITE_P(AllShapes, BufferShapeTest,
   ::testing::Values(std::vector<size_t>{1024}, std::vector<size_t>{1024, 1024}, std::vector<size_t>{1024, 1024, 4}));
 
+TEST(BufferZeroCopyTest, AliasesHostMemory) {
+  std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  ASSERT_TRUE(runtime && !runtime.getDevices().empty());
+  auto dev = runtime.getDevice(0);
+
+  std::vector<float> host(1024);
+  for (size_t i = 0; i < host.size(); ++i) host[i] = static_cast<float>(i);
+  auto buf = dev.createBuffer(host.size() * sizeof(float), host.data(),
+                              NXS_BufferSettings_ZeroCopy);
+  ASSERT_TRUE(buf);
+
+  // Only the CPU device is required to alias; elsewhere the flag is a hint
+  if (runtime_name == "cpu") {
+    ASSERT_EQ(reinterpret_cast<const void *>(buf.getDataPtr()),
+              reinterpret_cast<const void *>(host.data()));
+    host[3] = 42.0f;
+  }
+
+  std::vector<float> host_out(host.size());
+  ASSERT_EQ(buf.copy(host_out.data()), NXS_Success);
+  ASSERT_EQ(host_out, host);
+  ASSERT_EQ(buf.copy(host.data()), NXS_Success);
+  ASSERT_EQ(host_out, host);
+}
+
+TEST(BufferCopyTest, BothDirections) {
+  std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  ASSERT_TRUE(runtime && !runtime.getDevices().empty());
+  auto dev = runtime.getDevice(0);
+
+  // large enough to be split across workers
+  std::vector<uint32_t> host((3 << 20) + 7);
+  for (size_t i = 0; i < host.size(); ++i) host[i] = static_cast<uint32_t>(i);
+  auto buf = dev.createBuffer(host.size() * sizeof(uint32_t));
+  ASSERT_TRUE(buf);
+
+  ASSERT_EQ(buf.copy(host.data(), NXS_BufferHostToDevice), NXS_Success);
+  std::vector<uint32_t> host_out(host.size());
+  ASSERT_EQ(buf.copy(host_out.data(), NXS_BufferDeviceToHost), NXS_Success);
+  ASSERT_EQ(host_out, host);
+}
+
+TEST(BufferRegionTest, RowsTilesAndBuffers) {
+  std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  ASSERT_TRUE(runtime && !runtime.getDevices().empty());
+  auto dev = runtime.getDevice(0);
+
+  // 16 rows of 16 floats
+  const size_t n = 16, row_bytes = n * sizeof(float);
+  std::vector<float> host(n * n);
+  for (size_t i = 0; i < host.size(); ++i) host[i] = static_cast<float>(i);
+  auto buf = dev.createBuffer(host.size() * sizeof(float), host.data());
+  ASSERT_TRUE(buf);
+
+  // read back row 5
+  std::vector<float> row(n);
+  ASSERT_EQ(buf.copy(row.data(), 5 * row_bytes, row_bytes), NXS_Success);
+  ASSERT_EQ(row, std::vector<float>(host.begin() + 5 * n,
+                                    host.begin() + 6 * n));
+
+  // upload a 4x3 tile at row 2, column 8
+  std::vector<float> tile(12, -1.0f);
+  nxs_buffer_region region{};
+  region.rank = 2;
+  region.extent[0] = 4 * sizeof(float);
+  region.extent[1] = 3;
+  region.src_stride[1] = 4 * sizeof(float);
+  region.dst_offset = 2 * row_bytes + 8 * sizeof(float);
+  region.dst_stride[1] = row_bytes;
+  ASSERT_EQ(buf.copyRegion(tile.data(), region, NXS_BufferHostToDevice),
+            NXS_Success);
+  std::vector<float> host_out(host.size());
+  ASSERT_EQ(buf.copy(host_out.data()), NXS_Success);
+  for (size_t r = 0; r < n; ++r)
+    for (size_t c = 0; c < n; ++c) {
+      bool in_tile = r >= 2 && r < 5 && c >= 8 && c < 12;
+      ASSERT_EQ(host_out[r * n + c], in_tile ? -1.0f : host[r * n + c])
+          << "at " << r << "," << c;
+    }
+
+  // copy column 0 of buf into row 0 of another buffer
+  auto other = dev.createBuffer(host.size() * sizeof(float));
+  ASSERT_TRUE(other);
+  nxs_buffer_region column{};
+  column.rank = 2;
+  column.extent[0] = sizeof(float);
+  column.extent[1] = n;
+  column.src_stride[1] = row_bytes;
+  column.dst_stride[1] = sizeof(float);
+  ASSERT_EQ(buf.copyRegion(other, column), NXS_Success);
+  ASSERT_EQ(other.copy(row.data(), 0, row_bytes), NXS_Success);
+  for (size_t r = 0; r < n; ++r) ASSERT_EQ(row[r], host[r * n]);
+
+  // out of bounds
+  ASSERT_NE(buf.copy(row.data(), 15 * row_bytes + 4, row_bytes), NXS_Success);
+}
+
+// Region offsets of a strided view address its raw bytes (up to its last
+// element), not its packed elements
+bool copyViewRegions() {
+  std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
+  auto runtime = nexus::getSystem().getRuntime(runtime_name);
+  if (!runtime || runtime.getDevices().empty()) return false;
+  auto dev = runtime.getDevice(0);
+
+  // column 3 of 4 rows of 8 floats: 16 packed bytes, 100 raw ones
+  std::vector<float> host(32);
+  for (size_t i = 0; i < host.size(); ++i) host[i] = static_cast<float>(i);
+  auto buf = dev.createBuffer(std::vector<size_t>{8, 4}, host.data(),
+                              NXS_DataType_F32);
+  auto column = buf.createView(3 * sizeof(float),
+                               nexus::Layout(std::vector<size_t>{4},
+                                             std::vector<size_t>{8}));
+  if (!column) return false;
+
+  nxs_buffer_region region{};
+  region.rank = 2;
+  region.extent[0] = sizeof(float);
+  region.extent[1] = 4;
+  region.src_stride[1] = 8 * sizeof(float);
+  region.dst_stride[1] = sizeof(float);
+  std::vector<float> out(4);
+  if (column.copyRegion(out.data(), region, NXS_BufferDeviceToHost) !=
+          NXS_Success ||
+      out != std::vector<float>{3, 11, 19, 27})
+    return false;
+
+  // and back, into the last two elements
+  std::vector<float> values{-1, -2};
+  region.extent[1] = 2;
+  region.src_stride[1] = sizeof(float);
+  region.dst_offset = 16 * sizeof(float);
+  region.dst_stride[1] = 8 * sizeof(float);
+  if (column.copyRegion(values.data(), region, NXS_BufferHostToDevice) !=
+      NXS_Success)
+    return false;
+  std::vector<float> host_out(host.size());
+  if (buf.copy(host_out.data()) != NXS_Success) return false;
+  for (size_t i = 0; i < host.size(); ++i) {
+    float expected = i == 19 ? -1 : i == 27 ? -2 : host[i];
+    if (host_out[i] != expected) return false;
+  }
+
+  // past the last element
+  region.dst_offset = 17 * sizeof(float);
+  return column.copyRegion(values.data(), region, NXS_BufferHostToDevice) !=
+         NXS_Success;
+}
+
+TEST(BufferRegionTest, StridedView) { ASSERT_TRUE(copyViewRegions()); }
+
+// The same through the core's host staging, for runtimes without
+// nxsCopyBufferRegion; the plugin is loaded without it in a fresh process
+TEST(BufferRegionTest, StridedViewStaged) {
+  EXPECT_EXIT(
+      {
+        setenv("NEXUS_DISABLE_FUNCTIONS", "nxsCopyBufferRegion", 1);
+        std::exit(copyViewRegions() ? 0 : 1);
+      },
+      ::testing::ExitedWithCode(0), "");
+}
+
+class BufferAllocationTest : public ::testing::TestWithParam<nxs_uint> {};
+
+TEST_P(BufferAllocationTest, Settings) {
+  std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
+  nxs_uint settings = GetParam();
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  ASSERT_TRUE(runtime && !runtime.getDevices().empty());
+  auto dev = runtime.getDevice(0);
+
+  std::vector<uint32_t> host(3 << 20 >> 2);
+  for (size_t i = 0; i < host.size(); ++i) host[i] = static_cast<uint32_t>(i);
+  auto buf = dev.createBuffer(host.size() * sizeof(uint32_t), host.data(),
+                              settings);
+  ASSERT_TRUE(buf);
+
+  if (auto alignment = buf.getProperty(NP_Alignment)) {
+    auto align = alignment->getValue<nxs_long>();
+    ASSERT_GE(align, 64);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(buf.getDataPtr()) % align, 0u);
+    if (settings & NXS_BufferSettings_AlignPage) ASSERT_GE(align, 4096);
+  }
+
+  std::vector<uint32_t> host_out(host.size());
+  ASSERT_EQ(buf.copy(host_out.data()), NXS_Success);
+  ASSERT_EQ(host_out, host);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllSettings, BufferAllocationTest,
+  ::testing::Values(nxs_uint{0}, nxs_uint{NXS_BufferSettings_AlignPage},
+                    nxs_uint{NXS_BufferSettings_HugePages},
+                    nxs_uint{NXS_BufferSettings_FirstTouch},
+                    nxs_uint{NXS_BufferSettings_Interleave}));
+
+TEST(BufferViewTest, SharesParentMemory) {
+  std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  ASSERT_TRUE(runtime && !runtime.getDevices().empty());
+  auto dev = runtime.getDevice(0);
+
+  // 4 rows of 8 floats
+  std::vector<float> host(32);
+  for (size_t i = 0; i < host.size(); ++i) host[i] = static_cast<float>(i);
+  auto buf = dev.createBuffer(std::vector<size_t>{8, 4}, host.data(),
+                              NXS_DataType_F32);
+  ASSERT_TRUE(buf);
+
+  // rows 1 and 2
+  auto rows = buf.createView(8 * sizeof(float),
+                             nexus::Layout(std::vector<size_t>{8, 2}));
+  ASSERT_TRUE(rows);
+  ASSERT_EQ(rows.getLayout().getDataType(), NXS_DataType_F32);
+  ASSERT_EQ(rows.getSizeBytes(), 16 * sizeof(float));
+  ASSERT_EQ(rows.getOffset(), 8 * sizeof(float));
+  ASSERT_EQ(rows.getDataPtr(), buf.getDataPtr() + 8 * sizeof(float));
+  std::vector<float> rows_out(16);
+  ASSERT_EQ(rows.copy(rows_out.data()), NXS_Success);
+  ASSERT_EQ(rows_out, std::vector<float>(host.begin() + 8, host.begin() + 24));
+
+  // column 3, gathered on copy
+  auto column = buf.createView(3 * sizeof(float),
+                               nexus::Layout(std::vector<size_t>{4},
+                                             std::vector<size_t>{8}));
+  ASSERT_TRUE(column);
+  std::vector<float> column_out(4);
+  ASSERT_EQ(column.copy(column_out.data()), NXS_Success);
+  ASSERT_EQ(column_out, (std::vector<float>{3, 11, 19, 27}));
+
+  // transpose: dense but permuted, so copied in dim 0 order
+  auto transposed = buf.createView(0, nexus::Layout(std::vector<size_t>{4, 8},
+                                                    std::vector<size_t>{8, 1}));
+  ASSERT_TRUE(transposed);
+  std::vector<float> transposed_out(32);
+  ASSERT_EQ(transposed.copy(transposed_out.data()), NXS_Success);
+  for (size_t i = 0; i < transposed_out.size(); ++i)
+    ASSERT_EQ(transposed_out[i], host[(i % 4) * 8 + i / 4]) << "at " << i;
+
+  // writes through a view land in the parent
+  float zero = 0;
+  ASSERT_EQ(column.fill(&zero, sizeof(zero)), NXS_Success);
+  std::vector<float> host_out(host.size());
+  ASSERT_EQ(buf.copy(host_out.data()), NXS_Success);
+  for (size_t i = 0; i < host.size(); ++i)
+    ASSERT_EQ(host_out[i], i % 8 == 3 ? 0.0f : host[i]) << "at " << i;
+
+  // out of bounds
+  ASSERT_FALSE(buf.createView(20 * sizeof(float),
+                              nexus::Layout(std::vector<size_t>{16})));
+}
+
+// A zero dim makes an empty view, even one at the end of its parent;
+// filling and copying it touch nothing
+TEST(BufferViewTest, EmptyStridedView) {
+  std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  ASSERT_TRUE(runtime && !runtime.getDevices().empty());
+  auto dev = runtime.getDevice(0);
+
+  std::vector<float> host(32, 1.0f);
+  auto buf = dev.createBuffer(std::vector<size_t>{8, 4}, host.data(),
+                              NXS_DataType_F32);
+  ASSERT_TRUE(buf);
+
+  float zero = 0;
+  std::vector<float> out(1, -1.0f);
+  for (size_t offset : {size_t{8}, size_t{32}}) {
+    auto empty = buf.createView(
+        offset * sizeof(float),
+        nexus::Layout(std::vector<size_t>{4, 0}, std::vector<size_t>{2, 8}));
+    ASSERT_TRUE(empty) << "offset " << offset;
+    ASSERT_EQ(empty.getSizeBytes(), 0);
+    ASSERT_EQ(empty.fill(&zero, sizeof(zero)), NXS_Success);
+    ASSERT_EQ(empty.copy(out.data()), NXS_Success);
+    ASSERT_EQ(out[0], -1.0f);
+  }
+
+  std::vector<float> host_out(host.size());
+  ASSERT_EQ(buf.copy(host_out.data()), NXS_Success);
+  ASSERT_EQ(host_out, host);
+}
+
+// Names, sizes and the data pointer are cached from one packed query when
+// objects are created; they must match what the plugin reports.
+namespace {
+
+// A function of the plugin itself, bypassing the facade. The library is
+// already loaded by the runtime, so this shares its state.
+void *getPluginFunction(const std::string &name, const char *symbol) {
+  std::string path = "./runtime_libs/lib" + name + "_plugin.so";
+  void *lib = dlopen(path.c_str(), RTLD_NOW | RTLD_NOLOAD);
+  if (!lib) return nullptr;
+  return dlsym(lib, symbol);
+}
+
+// The plugin's own nxsGetBufferProperty, bypassing the facade's cache
+nxsGetBufferProperty_fn getPluginBufferProperty(const std::string &name) {
+  return (nxsGetBufferProperty_fn)getPluginFunction(name,
+                                                    "nxsGetBufferProperty");
+}
+
+nxs_long queryInt(nxsGetBufferProperty_fn query, nxs_int id, nxs_uint prop) {
+  nxs_long value = -1;
+  size_t size = sizeof(value);
+  if (query(id, prop, &value, &size) != NXS_Success) return -1;
+  return value;
+}
+
+std::string queryStr(nxsGetBufferProperty_fn query, nxs_int id,
+                     nxs_uint prop) {
+  char value[256] = {0};
+  size_t size = sizeof(value);
+  if (query(id, prop, value, &size) != NXS_Success) return "";
+  return value;
+}
+
+}  // namespace
+
+TEST(BufferPropertyTest, CachedAtCreation) {
+  std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  ASSERT_TRUE(runtime && !runtime.getDevices().empty());
+  ASSERT_EQ(runtime.getProp<std::string>(NP_Name), runtime_name);
+  auto dev = runtime.getDevice(0);
+  ASSERT_FALSE(dev.getProp<std::string>(NP_Architecture).empty());
+  auto query = getPluginBufferProperty(runtime_name);
+  ASSERT_NE(query, nullptr);
+
+  std::vector<float> host(32, 1.0f);
+  auto buf = dev.createBuffer(std::vector<size_t>{32}, host.data(),
+                              NXS_DataType_F32);
+  ASSERT_TRUE(buf);
+  auto *data = buf.getDataPtr();
+  ASSERT_NE(data, nullptr);
+  // cached answers agree with what the plugin reports now
+  EXPECT_EQ(reinterpret_cast<nxs_long>(data),
+            queryInt(query, buf.getId(), NP_Value));
+  EXPECT_EQ(buf.getProp<nxs_long>(NP_Value),
+            queryInt(query, buf.getId(), NP_Value));
+  EXPECT_EQ(buf.getProp<nxs_long>(NP_Alignment),
+            queryInt(query, buf.getId(), NP_Alignment));
+  EXPECT_EQ(buf.getProp<std::string>(NP_Placement),
+            queryStr(query, buf.getId(), NP_Placement));
+  EXPECT_FALSE(buf.getProp<std::string>(NP_Placement).empty());
+
+  auto view = buf.createView(4 * sizeof(float),
+                             nexus::Layout(std::vector<size_t>{8}));
+  ASSERT_TRUE(view);
+  EXPECT_EQ(view.getProp<nxs_long>(NP_Offset), 4 * sizeof(float));
+  EXPECT_EQ(view.getProp<nxs_long>(NP_Offset),
+            queryInt(query, view.getId(), NP_Offset));
+  EXPECT_EQ(reinterpret_cast<nxs_long>(view.getDataPtr()),
+            queryInt(query, view.getId(), NP_Value));
+  EXPECT_EQ(view.getDataPtr(), data + 4 * sizeof(float));
+}
+
+// The facade's Layout cannot hold more than NXS_MAX_DIMS dims, so the
+// plugin is handed the oversized layout directly
+TEST(BufferViewTest, RejectsRankAboveMax) {
+  std::string runtime_name = (g_argc > 1) ? g_argv[1] : "cpu";
+  if (runtime_name != "cpu") GTEST_SKIP();
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  ASSERT_TRUE(runtime && !runtime.getDevices().empty());
+  auto dev = runtime.getDevice(0);
+  auto create_view = (nxsCreateSubBuffer_fn)getPluginFunction(
+      runtime_name, "nxsCreateSubBuffer");
+  ASSERT_NE(create_view, nullptr);
+
+  auto buf = dev.createBuffer(1024, nullptr);
+  ASSERT_TRUE(buf);
+  nxs_buffer_layout shape{NXS_DataType_U8, NXS_MAX_DIMS + 1, {}, {}};
+  for (auto &dim : shape.dim) dim = 1;
+  EXPECT_FALSE(nxs_valid_id(create_view(buf.getId(), 0, shape, 0)));
+}
 
 int main(int argc, char** argv) {
   g_argc = argc;
   g_argv = argv;
   ::testing::InitGoogleTest(&argc, argv);
+  ::testing::GTEST_FLAG(death_test_style) = "threadsafe";
   return RUN_ALL_TESTS();
 }
\ No newline at end of file
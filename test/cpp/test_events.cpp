@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <nexus.h>
+
+#include <iostream>
+
+#define SUCCESS 0
+#define FAILURE 1
+
+int g_argc;
+char** g_argv;
+
+static bool check(nexus::Buffer buf, size_t vsize, float expected) {
+  std::vector<float> result(vsize, -1.0);
+  buf.copy(result.data(), NXS_BufferDeviceToHost);
+  for (size_t i = 0; i < vsize; ++i) {
+    if (result[i] != expected) {
+      std::cout << "Fail: result[" << i << "] = " << result[i] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Streams wait on events signaled by the host and by each other. Stream 1
+// is submitted before the stream it depends on, so its wait command must
+// not hold up the pool.
+int test_events(int argc, char** argv) {
+  if (argc < 4) {
+    std::cout << "Usage: " << argv[0]
+              << " <runtime_name> <kernel_file> <kernel_name>" << std::endl;
+    return FAILURE;
+  }
+
+  std::string runtime_name = argv[1];
+  std::string kernel_file = argv[2];
+  std::string kernel_name = argv[3];
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  if (!runtime) {
+    std::cout << "No runtimes found" << std::endl;
+    return FAILURE;
+  }
+
+  nexus::Device dev0 = runtime.getDevice(0);
+
+  const nxs_uint block = 32;
+  const nxs_uint grid = 8;
+  size_t vsize = block * grid;
+  size_t size = vsize * sizeof(float);
+
+  auto nlib = dev0.createLibrary(kernel_file);
+  auto kern = nlib.getKernel(kernel_name);
+  if (!kern) return FAILURE;
+
+  std::vector<float> ones(vsize, 1.0);
+  std::vector<float> zeros(vsize, 0.0);
+  auto bufOnes = dev0.createBuffer(size, ones.data());
+  auto bufA = dev0.createBuffer(size, zeros.data());
+  auto bufB = dev0.createBuffer(size, zeros.data());
+
+  auto stream0 = dev0.createStream();
+  auto stream1 = dev0.createStream();
+
+  auto evHost = dev0.createEvent();
+  auto ev0 = dev0.createEvent();
+  auto ev1 = dev0.createEvent();
+
+  // Stream 0: wait for the host, A = 1 + 1, release stream 1 (ev0 = 1),
+  // wait for stream 1 to finish (ev1 = 2)
+  auto sched0 = dev0.createSchedule();
+  sched0.createWaitCommand(evHost, 1);
+  auto cmd0 = sched0.createCommand(kern);
+  cmd0.setArgument(0, bufOnes);
+  cmd0.setArgument(1, bufOnes);
+  cmd0.setArgument(2, bufA);
+  cmd0.finalize({grid, 1, 1}, {block, 1, 1}, 0);
+  sched0.createSignalCommand(ev0, 1);
+  sched0.createWaitCommand(ev1, 2);
+
+  // Stream 1: wait for stream 0, B = A + 1, then bump ev1 to 2
+  auto sched1 = dev0.createSchedule();
+  sched1.createWaitCommand(ev0, 1);
+  auto cmd1 = sched1.createCommand(kern);
+  cmd1.setArgument(0, bufA);
+  cmd1.setArgument(1, bufOnes);
+  cmd1.setArgument(2, bufB);
+  cmd1.finalize({grid, 1, 1}, {block, 1, 1}, 0);
+  sched1.createSignalCommand(ev1, 2);
+
+  sched1.run(stream1, NXS_ExecutionSettings_NonBlocking);
+  sched0.run(stream0, NXS_ExecutionSettings_NonBlocking);
+
+  if (ev0.getProp<nxs_long>(NP_Value) != 0) {
+    std::cout << "Fail: stream 0 ran before the host signal" << std::endl;
+    return FAILURE;
+  }
+
+  // Buffers the parked streams do not use must not wait for them, or the
+  // host would never get to the signal below
+  {
+    auto bufTmp = dev0.createBuffer(size, zeros.data());
+    float one = 1.0f;
+    bufTmp.fill(&one, sizeof(one));
+    if (!check(bufTmp, vsize, 1.0)) return FAILURE;
+  }
+
+  evHost.signal(1);
+  ev1.wait(2);
+
+  if (!check(bufA, vsize, 2.0) || !check(bufB, vsize, 3.0)) return FAILURE;
+
+  // Timeline values only move forward
+  ev1.signal(1);
+  if (ev1.getProp<nxs_long>(NP_Value) != 2) {
+    std::cout << "Fail: event value went backwards" << std::endl;
+    return FAILURE;
+  }
+
+  std::cout << std::endl << "Test PASSED" << std::endl << std::endl;
+
+  return SUCCESS;
+}
+
+// Create the NexusIntegration test fixture class
+class NexusIntegration : public ::testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(NexusIntegration, EVENTS) {
+  int result = test_events(g_argc, g_argv);
+  EXPECT_EQ(result, SUCCESS);
+}
+
+int main(int argc, char** argv) {
+  g_argc = argc;
+  g_argv = argv;
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
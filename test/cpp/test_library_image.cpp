@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <nexus.h>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#define SUCCESS 0
+#define FAILURE 1
+
+int g_argc;
+char** g_argv;
+
+// Load the kernel library from a memory image instead of a path. Loading
+// the same bytes twice must hand back the same underlying library.
+int test_library_image(int argc, char** argv) {
+  if (argc < 4) {
+    std::cout << "Usage: " << argv[0]
+              << " <runtime_name> <kernel_file> <kernel_name>" << std::endl;
+    return FAILURE;
+  }
+
+  std::string runtime_name = argv[1];
+  std::string kernel_file = argv[2];
+  std::string kernel_name = argv[3];
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  if (!runtime) {
+    std::cout << "No runtimes found" << std::endl;
+    return FAILURE;
+  }
+
+  nexus::Device dev0 = runtime.getDevice(0);
+
+  std::ifstream file(kernel_file, std::ios::binary);
+  std::vector<char> image((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+  if (image.empty()) {
+    std::cout << "Failed to read " << kernel_file << std::endl;
+    return FAILURE;
+  }
+
+  auto lib0 = dev0.createLibrary(image.data(), image.size());
+  auto lib1 = dev0.createLibrary(image.data(), image.size());
+  if (!lib0 || !lib1) {
+    std::cout << "Failed to load library image" << std::endl;
+    return FAILURE;
+  }
+  if (lib0.getProp<nxs_long>(NP_Value) != lib1.getProp<nxs_long>(NP_Value)) {
+    std::cout << "Fail: identical images were loaded twice" << std::endl;
+    return FAILURE;
+  }
+
+  auto kern = lib1.getKernel(kernel_name);
+  if (!kern) return FAILURE;
+
+  const nxs_uint block = 32;
+  const nxs_uint grid = 8;
+  size_t vsize = block * grid;
+  size_t size = vsize * sizeof(float);
+  std::vector<float> vecA(vsize, 1.0);
+  std::vector<float> vecB(vsize, 2.0);
+  std::vector<float> vecOut(vsize, 0.0);
+
+  auto buf0 = dev0.createBuffer(size, vecA.data());
+  auto buf1 = dev0.createBuffer(size, vecB.data());
+  auto buf2 = dev0.createBuffer(size, vecOut.data());
+
+  auto sched = dev0.createSchedule();
+  auto cmd = sched.createCommand(kern);
+  cmd.setArgument(0, buf0);
+  cmd.setArgument(1, buf1);
+  cmd.setArgument(2, buf2);
+  cmd.finalize({grid, 1, 1}, {block, 1, 1}, 0);
+  sched.run(nexus::Stream());
+
+  buf2.copy(vecOut.data(), NXS_BufferDeviceToHost);
+  for (size_t i = 0; i < vsize; ++i) {
+    if (vecOut[i] != 3.0) {
+      std::cout << "Fail: result[" << i << "] = " << vecOut[i] << std::endl;
+      return FAILURE;
+    }
+  }
+
+  std::cout << std::endl << "Test PASSED" << std::endl << std::endl;
+
+  return SUCCESS;
+}
+
+// Create the NexusIntegration test fixture class
+class NexusIntegration : public ::testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(NexusIntegration, LIBRARY_IMAGE) {
+  int result = test_library_image(g_argc, g_argv);
+  EXPECT_EQ(result, SUCCESS);
+}
+
+int main(int argc, char** argv) {
+  g_argc = argc;
+  g_argv = argv;
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <nexus.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+
+#define SUCCESS 0
+#define FAILURE 1
+
+int g_argc;
+char** g_argv;
+
+int test_shared_memory(int argc, char** argv) {
+  if (argc < 4) {
+    std::cout << "Usage: " << argv[0]
+              << " <runtime_name> <kernel_file> <kernel_name>" << std::endl;
+    return FAILURE;
+  }
+
+  std::string runtime_name = argv[1];
+  std::string kernel_file = argv[2];
+  std::string kernel_name = argv[3];
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  if (!runtime) {
+    std::cout << "No runtimes found" << std::endl;
+    return FAILURE;
+  }
+
+  nexus::Device dev0 = runtime.getDevice(0);
+
+  const nxs_uint block = 32;
+  const nxs_uint grid = 64;
+  size_t vsize = block * grid;
+  std::vector<float> vecIn(vsize);
+  std::iota(vecIn.begin(), vecIn.end(), 0.f);
+  std::vector<float> vecOut(vsize, 0.0);
+
+  size_t size = vsize * sizeof(float);
+
+  auto nlib = dev0.createLibrary(kernel_file);
+
+  auto kern = nlib.getKernel(kernel_name);
+  if (!kern) return FAILURE;
+
+  auto buf0 = dev0.createBuffer(size, vecIn.data());
+  auto buf1 = dev0.createBuffer(size, vecOut.data());
+  auto stream0 = dev0.createStream();
+
+  auto sched = dev0.createSchedule();
+
+  auto cmd = sched.createCommand(kern);
+  cmd.setArgument(0, buf0);
+  cmd.setArgument(1, buf1);
+
+  cmd.finalize({grid, 1, 1}, {block, 1, 1}, block * sizeof(float));
+
+  // Scratch arenas are sized on the first run and reused afterwards
+  sched.run(stream0);
+  auto reserved = runtime.getProp<nxs_long>(NP_ScratchMemorySize);
+  sched.run(stream0);
+
+  if (runtime.getProp<nxs_long>(NP_ScratchMemorySize) != reserved) {
+    std::cout << "Fail: scratch memory grew between runs" << std::endl;
+    return FAILURE;
+  }
+  if (runtime.getProp<nxs_long>(NP_ScratchMemoryUsed) != 0 ||
+      runtime.getProp<nxs_long>(NP_ScratchMemoryPeak) <
+          (nxs_long)(block * sizeof(float))) {
+    std::cout << "Fail: unexpected scratch usage" << std::endl;
+    return FAILURE;
+  }
+
+  buf1.copy(vecOut.data(), NXS_BufferDeviceToHost);
+
+  for (size_t i = 0; i < vsize; ++i) {
+    size_t base = i - i % block;
+    float expected = vecIn[base + block - 1 - i % block];
+    if (vecOut[i] != expected) {
+      std::cout << "Fail: result[" << i << "] = " << vecOut[i] << std::endl;
+      return FAILURE;
+    }
+  }
+
+  std::cout << std::endl << "Test PASSED" << std::endl << std::endl;
+
+  return SUCCESS;
+}
+
+// Create the NexusIntegration test fixture class
+class NexusIntegration : public ::testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(NexusIntegration, SHARED_MEMORY) {
+  int result = test_shared_memory(g_argc, g_argv);
+  EXPECT_EQ(result, SUCCESS);
+}
+
+int main(int argc, char** argv) {
+  g_argc = argc;
+  g_argv = argv;
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
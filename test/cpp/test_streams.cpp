@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <nexus.h>
+
+#include <iostream>
+
+#define SUCCESS 0
+#define FAILURE 1
+
+int g_argc;
+char** g_argv;
+
+// Two streams each run a chain of dependent non-blocking schedules
+// (buf[i+1] = buf[i] + ones). The chains only come out right if every
+// stream keeps submission order; a final blocking run waits for the rest.
+int test_streams(int argc, char** argv) {
+  if (argc < 4) {
+    std::cout << "Usage: " << argv[0]
+              << " <runtime_name> <kernel_file> <kernel_name>" << std::endl;
+    return FAILURE;
+  }
+
+  std::string runtime_name = argv[1];
+  std::string kernel_file = argv[2];
+  std::string kernel_name = argv[3];
+
+  auto sys = nexus::getSystem();
+  auto runtime = sys.getRuntime(runtime_name);
+  if (!runtime) {
+    std::cout << "No runtimes found" << std::endl;
+    return FAILURE;
+  }
+
+  nexus::Device dev0 = runtime.getDevice(0);
+
+  const nxs_uint block = 32;
+  const nxs_uint grid = 32;
+  const int chain = 8;
+  size_t vsize = block * grid;
+  size_t size = vsize * sizeof(float);
+
+  auto nlib = dev0.createLibrary(kernel_file);
+  auto kern = nlib.getKernel(kernel_name);
+  if (!kern) return FAILURE;
+
+  std::vector<float> ones(vsize, 1.0);
+  std::vector<float> zeros(vsize, 0.0);
+  auto bufOnes = dev0.createBuffer(size, ones.data());
+
+  struct Chain {
+    nexus::Stream stream;
+    std::vector<nexus::Buffer> bufs;
+    std::vector<nexus::Schedule> scheds;
+  };
+  Chain chains[2];
+
+  for (auto& c : chains) {
+    c.stream = dev0.createStream();
+    for (int i = 0; i <= chain; ++i)
+      c.bufs.push_back(dev0.createBuffer(size, zeros.data()));
+    for (int i = 0; i < chain; ++i) {
+      auto sched = dev0.createSchedule();
+      auto cmd = sched.createCommand(kern);
+      cmd.setArgument(0, c.bufs[i]);
+      cmd.setArgument(1, bufOnes);
+      cmd.setArgument(2, c.bufs[i + 1]);
+      cmd.finalize({grid, 1, 1}, {block, 1, 1}, 0);
+      c.scheds.push_back(sched);
+    }
+  }
+
+  // Interleave submissions across both streams
+  for (int i = 0; i < chain - 1; ++i)
+    for (auto& c : chains)
+      c.scheds[i].run(c.stream, NXS_ExecutionSettings_NonBlocking);
+  for (auto& c : chains) c.scheds[chain - 1].run(c.stream);
+
+  for (auto& c : chains) {
+    std::vector<float> result(vsize, 0.0);
+    c.bufs[chain].copy(result.data(), NXS_BufferDeviceToHost);
+    for (size_t i = 0; i < vsize; ++i) {
+      if (result[i] != (float)chain) {
+        std::cout << "Fail: result[" << i << "] = " << result[i] << std::endl;
+        return FAILURE;
+      }
+    }
+  }
+
+  std::cout << std::endl << "Test PASSED" << std::endl << std::endl;
+
+  return SUCCESS;
+}
+
+// Create the NexusIntegration test fixture class
+class NexusIntegration : public ::testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(NexusIntegration, STREAMS) {
+  int result = test_streams(g_argc, g_argv);
+  EXPECT_EQ(result, SUCCESS);
+}
+
+int main(int argc, char** argv) {
+  g_argc = argc;
+  g_argv = argv;
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
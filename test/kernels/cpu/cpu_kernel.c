@@ -10,3 +10,37 @@ void add_vectors(float *a, float *b, float *out, int launch_size[],
   out += launch_id[0] * stride;
   out[launch_id[3]] = a[launch_id[3]] + b[launch_id[3]];
 }
+
+void empty_kernel(int launch_size[], int launch_id[], void *shared_memory) {}
+
+// Packed arguments: 40 inputs followed by the output
+void sum_inputs_packed(void *const *args, void *const *launch) {
+  const uint32 stride = 32;
+  const int *launch_id = (const int *)launch[1];
+  const int i = launch_id[0] * stride + launch_id[3];
+  float *out = (float *)args[40];
+  float sum = 0;
+  for (int k = 0; k < 40; ++k) sum += ((float *)args[k])[i];
+  out[i] = sum;
+}
+
+// 30 inputs and the output fill all but the launch size of the 32 pointer
+// parameters, so there is no launch id: every work-item claims the next
+// element from a ticket kept in out[n]
+void sum_inputs_31(float *i0, float *i1, float *i2, float *i3, float *i4,
+                   float *i5, float *i6, float *i7, float *i8, float *i9,
+                   float *i10, float *i11, float *i12, float *i13, float *i14,
+                   float *i15, float *i16, float *i17, float *i18, float *i19,
+                   float *i20, float *i21, float *i22, float *i23, float *i24,
+                   float *i25, float *i26, float *i27, float *i28, float *i29,
+                   float *out, int launch_size[]) {
+  float *in[30] = {i0,  i1,  i2,  i3,  i4,  i5,  i6,  i7,  i8,  i9,
+                   i10, i11, i12, i13, i14, i15, i16, i17, i18, i19,
+                   i20, i21, i22, i23, i24, i25, i26, i27, i28, i29};
+  const int n = launch_size[0] * launch_size[3];
+  const int i = __atomic_fetch_add((int *)(out + n), 1, __ATOMIC_RELAXED);
+  if (i >= n) return;
+  float sum = 0;
+  for (int k = 0; k < 30; ++k) sum += in[k][i];
+  out[i] = sum;
+}
@@ -0,0 +1,14 @@
+extern void _cpu_barrier(void *barrier);
+
+// Reverse each block of `in` through team shared memory.
+void reverse_block(float *in, float *out, int launch_size[], int launch_id[],
+                   void *shared_memory, void *cpu_barrier) {
+  float *tile = (float *)shared_memory;
+  const int block = launch_size[3];
+  const int base = launch_id[0] * block;
+  const int tid = launch_id[3];
+
+  tile[tid] = in[base + tid];
+  _cpu_barrier(cpu_barrier);
+  out[base + tid] = tile[block - 1 - tid];
+}
@@ -178,13 +178,16 @@ class CppLibraryCatalogBuilder:
             if any(c in func_name for c in '<>()'):
                 continue
                 
+            parameters = self._parse_parameters_preprocessed(params_str)
             function_info = {
                 "Name": func_name,
                 "Symbol": func_name,  # Will be updated with mangled name later
                 "Description": "",
                 "ReturnType": self._normalize_type(return_type),
-                "Parameters": self._parse_parameters_preprocessed(params_str),
+                "Parameters": parameters,
                 "CallingConvention": "CDECL",
+                "BarrierFree": "_cpu_barrier" not in cleaned_source,
+                "PackedArgs": self._is_packed_signature(parameters),
                 "ThreadSafety": "Unknown",
                 "Deprecated": False,
                 "SinceVersion": "1.0.0"
@@ -194,6 +197,13 @@ class CppLibraryCatalogBuilder:
         
         return functions
 
+    def _is_packed_signature(self, parameters: List[Dict[str, Any]]) -> bool:
+        """True for kernels taking (void *const *args, void *const *launch)"""
+        if len(parameters) != 2:
+            return False
+        types = [re.sub(r'\s+', '', p.get("Type", "")) for p in parameters]
+        return all(t in ("void**", "void*const*") for t in types)
+
     def _clean_preprocessed_source(self, source: str) -> str:
         """Clean preprocessed source for easier parsing"""
         lines = []
@@ -318,6 +328,7 @@ class CppLibraryCatalogBuilder:
             "Optional": default_value is not None,
             "Qualifiers": self._extract_type_qualifiers(param_type),
             "PointerLevel": param_type.count('*'),
+            "PointeeConst": self._is_pointee_const(param_type),
             "IsReference": '&' in param_type
         }
         
@@ -344,6 +355,13 @@ class CppLibraryCatalogBuilder:
                 qualifiers.append(qual)
         return qualifiers
 
+    def _is_pointee_const(self, type_str: str) -> bool:
+        """True for `const T *` / `T const *`; `T *const` writes through"""
+        if type_str.count('*') != 1:
+            return False
+        pointee = type_str.split('*', 1)[0]
+        return re.search(r'\bconst\b', pointee) is not None
+
     def analyze_binary_library(self, library_path: str) -> Dict[str, Any]:
         """Analyze compiled binary library"""
         lib_path = Path(library_path)